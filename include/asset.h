@@ -0,0 +1,21 @@
+#ifndef ASSET_H
+#define ASSET_H
+
+#include <Arduino.h>
+
+/**
+ * Run-length compressed 1-bit images kept in flash (assets.h, generated
+ * from assets/ by tools/gen_assets.py). asset_draw() reads the runs one at
+ * a time and writes every set run into the panel buffer as a single span,
+ * so nothing is unpacked into SRAM. Clear pixels are left untouched.
+ *
+ * Blob layout: width, height, flags, then run lengths alternating between
+ * clear and set, starting with clear. With ASSET_COLUMNS the runs walk the
+ * image column by column instead of row by row.
+ */
+
+#define ASSET_COLUMNS 0x01
+
+void asset_draw(const uint8_t *asset, int16_t x, int16_t y, uint16_t color);
+
+#endif
@@ -0,0 +1,26 @@
+// Generated by tools/gen_assets.py from assets/, do not edit.
+
+#ifndef ASSETS_H
+#define ASSETS_H
+
+#include <Arduino.h>
+
+// logo.pbm, 60x30, 180 bytes, column-major
+#define ASSET_LOGO_WIDTH 60
+#define ASSET_LOGO_HEIGHT 30
+static const uint8_t asset_logo[] PROGMEM = {
+  60, 30, 1, 0, 19, 10, 20, 3, 1, 1, 6, 60, 19, 5, 5, 1,
+  19, 9, 1, 29, 1, 1, 19, 5, 5, 61, 19, 3, 7, 1, 19, 9,
+  1, 1, 19, 9, 1, 61, 19, 3, 1, 1, 5, 61, 19, 5, 1, 1,
+  3, 25, 1, 1, 1, 1, 1, 1, 19, 5, 1, 1, 1, 1, 1, 1,
+  19, 5, 5, 61, 19, 5, 5, 1, 19, 5, 1, 29, 1, 5, 19, 5,
+  5, 61, 25, 3, 1, 61, 19, 5, 3, 1, 1, 1, 19, 5, 1, 1,
+  1, 1, 1, 25, 1, 1, 1, 1, 1, 1, 19, 5, 1, 1, 3, 61,
+  19, 5, 1, 2, 2, 1, 19, 5, 1, 1, 1, 1, 1, 25, 2, 2,
+  1, 1, 19, 5, 1, 3, 1, 61, 19, 5, 5, 1, 19, 9, 1, 29,
+  1, 1, 19, 5, 5, 61, 19, 3, 7, 1, 19, 9, 1, 1, 19, 9,
+  1, 61, 19, 5, 5, 25, 1, 3, 1, 25, 1, 3, 1, 1, 19, 5,
+  1, 3, 1, 1,
+};
+
+#endif
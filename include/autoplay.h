@@ -0,0 +1,51 @@
+#ifndef AUTOPLAY_H
+#define AUTOPLAY_H
+
+#include <Arduino.h>
+
+/**
+ * The player of the attract mode. Its safety net is a Hamiltonian cycle
+ * through the 62x30 field: rows snake left and right over columns 2..62
+ * and column 1 leads back up, so the snake following it can never run
+ * into itself.
+ *
+ * To get to the food sooner, a neighbour of the head may be taken instead
+ * of the next cell of the cycle when it lies ahead of the head, no further
+ * along the cycle than the food, and leaves more free cells before the
+ * tail than the snake is long, so the body stays in cycle order behind
+ * the head. Of those, a breadth-first search picks the one on a shortest
+ * path: it floods outwards from the food, one bitboard_wave() at a time,
+ * through the free cells between the head and the food along the cycle,
+ * until it reaches one. Shortcuts stop once the snake fills half the
+ * field.
+ *
+ * The search runs in slices of AUTOPLAY_SLICE_WAVES waves from
+ * autoplay_step(), between the ticks. A tick that comes before the search
+ * is done takes the cycle, so the search never holds a tick back by more
+ * than one slice, however long the snake.
+ *
+ * With the session log on, every demo game ends with
+ *
+ *   A <games> <points> <avg_points> <ticks> <avg_us> <max_us> <slice_us> <late>
+ *
+ * giving the average score over the demo games since power-up, and for
+ * this game the search time spent per tick, on average and at worst, the
+ * longest slice and the number of ticks that fell back on the cycle.
+ * Numbers are hex.
+ */
+
+#ifndef AUTOPLAY_SLICE_WAVES
+#define AUTOPLAY_SLICE_WAVES 4
+#endif
+
+// Cycle cells kept free between a shortcut and the tail, on top of the
+// snake's length and the growth still pending.
+#define AUTOPLAY_SLACK 4
+
+void autoplay_begin();
+void autoplay_plan();
+void autoplay_step();
+int autoplay_move();
+void autoplay_end();
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <Arduino.h>
+
+/**
+ * The playfield as one uint64_t per row, bit x for column x. That is the
+ * layout board[] already has on a little-endian CPU (the AVR and the
+ * host), so its rows are read as walls directly; a set bit blocks.
+ *
+ * Flood fills work on whole rows: a step spreads a row sideways with two
+ * shifts, takes in the rows above and below and masks off the walls with
+ * an AND-NOT, instead of visiting cells.
+ *
+ *   bitboard_wave()  one breadth-first step through the cells a callback
+ *                    opens row by row; cells reached by the n-th call are
+ *                    n steps from the start
+ *   bitboard_fill()  everything reachable from a cell, in as few passes
+ *                    as possible: each row is closed over its free runs
+ *                    (rightwards in one carry chain) and passes alternate
+ *                    down and up the field
+ *
+ * Building with -DBITBOARD_BENCHMARK=1 runs bitboard_benchmark() at
+ * power-up. It fills three fields, an open one ("open") and corridors
+ * running along the rows ("rows") and along the columns ("cols"), and
+ * prints one "F <board> <cells> <time per fill>" line each, in hex; the
+ * time is in CPU cycles on the console and nanoseconds on the host, as in
+ * profile.h.
+ */
+
+#define BITBOARD_ROWS 32
+
+void bitboard_clear(uint64_t bits[]);
+bool bitboard_test(const uint64_t bits[], unsigned int pos);
+void bitboard_set(uint64_t bits[], unsigned int pos);
+void bitboard_free(uint64_t bits[], const uint8_t walls[]);
+// The cells of row y bitboard_wave() may spread into.
+typedef uint64_t (*bitboard_row)(uint8_t y);
+
+bool bitboard_wave(uint64_t bits[], bitboard_row open_row, uint8_t &first, uint8_t &last);
+unsigned int bitboard_fill(uint64_t bits[], const uint8_t walls[], unsigned int from);
+unsigned int bitboard_count(const uint64_t bits[], unsigned int first, unsigned int last);
+unsigned int bitboard_nth(const uint64_t bits[], unsigned int first, unsigned int last, unsigned int n);
+
+#ifndef BITBOARD_BENCHMARK
+#define BITBOARD_BENCHMARK 0
+#endif
+
+#if BITBOARD_BENCHMARK
+void bitboard_benchmark(uint8_t walls[], uint64_t bits[]);
+#endif
+
+#endif
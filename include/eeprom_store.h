@@ -0,0 +1,24 @@
+#ifndef EEPROM_STORE_H
+#define EEPROM_STORE_H
+
+#include <Arduino.h>
+
+/**
+ * Background EEPROM writes. store_put() returns at once; the EE_READY
+ * interrupt then programs, one at a time, only the bytes of the block whose
+ * stored value differs, working from the end of the block down to its
+ * start. A block that begins with its own checksum thus has the checksum
+ * written last, and a write cut off by a power loss reads back with a
+ * checksum that does not match.
+ *
+ * The block is read in place, so the caller keeps it unchanged until
+ * store_busy() turns false. One block is in flight at a time: queueing
+ * another block waits for the previous one first.
+ */
+
+uint16_t store_crc(uint16_t crc, const void *data, unsigned int len);
+void store_put(int address, const void *data, uint8_t len);
+bool store_busy();
+void store_wait();
+
+#endif
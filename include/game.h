@@ -0,0 +1,64 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <Arduino.h>
+#include "bitboard.h"
+
+/**
+ * Playfield and snake state shared by the game (main.cpp) and the modules
+ * that drive or inspect it without the panel loop.
+ */
+
+#define GET_X(p) p%64
+#define GET_Y(p) p/64
+#define GET_POS(x,y) (64*y+x)
+
+#define BOARD_BYTES (64*32/8)
+
+#define DIR_UP -64
+#define DIR_RIGHT 1
+#define DIR_DOWN 64
+#define DIR_LEFT -1
+
+#define SNAKE_MAX_LEN (62*30)
+#define TURN_QUEUE_LEN 4
+
+// 1: body kept as a 2-bit step per segment (465 bytes at full length),
+// 0: body kept as a ring of cell positions (3720 bytes).
+#ifndef SNAKE_PACKED_BODY
+#define SNAKE_PACKED_BODY 1
+#endif
+
+#if SNAKE_PACKED_BODY
+typedef uint8_t snake_cell;
+#define SNAKE_CELLS (SNAKE_MAX_LEN/4)
+#else
+typedef unsigned int snake_cell;
+#define SNAKE_CELLS SNAKE_MAX_LEN
+#endif
+
+#define GAME_RUNNING 0
+#define GAME_CRASHED 1
+#define GAME_WON 2
+
+extern uint8_t board[BOARD_BYTES];
+// Free cells the head can reach, as of the last tick. Only read during a
+// tick, so it doubles as scratch space in between: the demo's search, and
+// the high score record while it is saved.
+extern uint64_t reach[BITBOARD_ROWS];
+extern unsigned int snake_len;
+extern unsigned int snake_grow;
+extern unsigned int snake_head_pos;
+extern unsigned int snake_tail_pos;
+extern int snake_direction;
+extern int snake_next_dir;
+extern unsigned int food;
+extern uint16_t points;
+
+bool board_test(unsigned int pos);
+void start_game(snake_cell snake[], unsigned long seed);
+bool queue_turn(int dir);
+uint8_t game_tick(snake_cell snake[]);
+uint16_t game_checksum(uint16_t crc);
+
+#endif
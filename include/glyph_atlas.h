@@ -0,0 +1,302 @@
+// Generated by tools/gen_glyph_atlas.py from lib/GFX_fonts, do not edit.
+
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <Arduino.h>
+
+// Font5x7FixedMono, 0x20..0x7E, 7 rows from 7 above the baseline
+#define FONT_5X7 0
+static constexpr uint8_t atlas_5x7_rows[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // ' '
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x00, 0x20,  // '!'
+  0x50, 0x50, 0x00, 0x00, 0x00, 0x00, 0x00,  // '"'
+  0x50, 0x50, 0xF8, 0x50, 0xF8, 0x50, 0x50,  // '#'
+  0x20, 0x78, 0xA0, 0x70, 0x28, 0xF0, 0x20,  // '$'
+  0xC0, 0xC8, 0x10, 0x20, 0x40, 0x98, 0x18,  // '%'
+  0x60, 0x90, 0xA0, 0x40, 0xA8, 0x90, 0x68,  // '&'
+  0x60, 0x20, 0x40, 0x00, 0x00, 0x00, 0x00,  // "'"
+  0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x10,  // '('
+  0x40, 0x20, 0x20, 0x20, 0x20, 0x20, 0x40,  // ')'
+  0x20, 0xA8, 0x70, 0xF8, 0x70, 0xA8, 0x20,  // '*'
+  0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00,  // '+'
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x20,  // ','
+  0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00,  // '-'
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60,  // '.'
+  0x00, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00,  // '/'
+  0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70,  // '0'
+  0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70,  // '1'
+  0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xF8,  // '2'
+  0xF8, 0x10, 0x20, 0x10, 0x08, 0x88, 0x70,  // '3'
+  0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10,  // '4'
+  0xF8, 0x80, 0x80, 0xF0, 0x08, 0x88, 0x70,  // '5'
+  0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70,  // '6'
+  0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40,  // '7'
+  0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70,  // '8'
+  0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60,  // '9'
+  0x00, 0x60, 0x60, 0x00, 0x60, 0x60, 0x00,  // ':'
+  0x00, 0x60, 0x60, 0x00, 0x60, 0x20, 0x40,  // ';'
+  0x10, 0x20, 0x40, 0x80, 0x40, 0x20, 0x10,  // '<'
+  0x00, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x00,  // '='
+  0x40, 0x20, 0x10, 0x08, 0x10, 0x20, 0x40,  // '>'
+  0x70, 0x88, 0x08, 0x10, 0x20, 0x00, 0x20,  // '?'
+  0x70, 0x88, 0xA8, 0xB8, 0xB8, 0x80, 0x70,  // '@'
+  0x20, 0x50, 0x88, 0xF8, 0x88, 0x88, 0x88,  // 'A'
+  0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0,  // 'B'
+  0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70,  // 'C'
+  0xE0, 0x90, 0x88, 0x88, 0x88, 0x90, 0xE0,  // 'D'
+  0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8,  // 'E'
+  0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80,  // 'F'
+  0x70, 0x88, 0x80, 0x98, 0x88, 0x88, 0x70,  // 'G'
+  0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88,  // 'H'
+  0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70,  // 'I'
+  0x38, 0x10, 0x10, 0x10, 0x10, 0x90, 0x60,  // 'J'
+  0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88,  // 'K'
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8,  // 'L'
+  0x88, 0xD8, 0xA8, 0x88, 0x88, 0x88, 0x88,  // 'M'
+  0x88, 0x88, 0xC8, 0xA8, 0x98, 0x88, 0x88,  // 'N'
+  0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70,  // 'O'
+  0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80,  // 'P'
+  0x70, 0x88, 0x88, 0x88, 0xA8, 0x90, 0x68,  // 'Q'
+  0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88,  // 'R'
+  0x78, 0x80, 0x80, 0x70, 0x08, 0x08, 0xF0,  // 'S'
+  0xF8, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,  // 'T'
+  0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70,  // 'U'
+  0x88, 0x88, 0x88, 0x88, 0x88, 0x50, 0x20,  // 'V'
+  0x88, 0x88, 0x88, 0x88, 0xA8, 0xD8, 0x88,  // 'W'
+  0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88,  // 'X'
+  0x88, 0x88, 0x50, 0x20, 0x20, 0x20, 0x20,  // 'Y'
+  0xF8, 0x08, 0x10, 0x20, 0x40, 0x80, 0xF8,  // 'Z'
+  0x70, 0x40, 0x40, 0x40, 0x40, 0x40, 0x70,  // '['
+  0x00, 0x80, 0x40, 0x20, 0x10, 0x08, 0x00,  // '\\'
+  0x70, 0x10, 0x10, 0x10, 0x10, 0x10, 0x70,  // ']'
+  0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00,  // '^'
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8,  // '_'
+  0x40, 0x20, 0x10, 0x00, 0x00, 0x00, 0x00,  // '`'
+  0x00, 0x00, 0x70, 0x08, 0x78, 0x88, 0x78,  // 'a'
+  0x80, 0x80, 0xF0, 0x88, 0x88, 0x88, 0xF0,  // 'b'
+  0x00, 0x00, 0x78, 0x80, 0x80, 0x80, 0x78,  // 'c'
+  0x08, 0x08, 0x78, 0x88, 0x88, 0x88, 0x78,  // 'd'
+  0x00, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x70,  // 'e'
+  0x20, 0x50, 0x40, 0xE0, 0x40, 0x40, 0x40,  // 'f'
+  0x00, 0x00, 0x78, 0x88, 0x78, 0x08, 0x70,  // 'g'
+  0x80, 0x80, 0xF0, 0x88, 0x88, 0x88, 0x88,  // 'h'
+  0x20, 0x00, 0x20, 0x20, 0x20, 0x20, 0x20,  // 'i'
+  0x10, 0x00, 0x10, 0x10, 0x10, 0x90, 0x60,  // 'j'
+  0x80, 0x80, 0x90, 0xA0, 0xC0, 0xA0, 0x90,  // 'k'
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,  // 'l'
+  0x00, 0x00, 0xD8, 0xA8, 0xA8, 0x88, 0x88,  // 'm'
+  0x00, 0x00, 0xB0, 0xC8, 0x88, 0x88, 0x88,  // 'n'
+  0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70,  // 'o'
+  0x00, 0x00, 0xF0, 0x88, 0xF0, 0x80, 0x80,  // 'p'
+  0x00, 0x00, 0x78, 0x88, 0x78, 0x08, 0x08,  // 'q'
+  0x00, 0x00, 0xB0, 0xC8, 0x80, 0x80, 0x80,  // 'r'
+  0x00, 0x00, 0x78, 0x80, 0x70, 0x08, 0xF0,  // 's'
+  0x20, 0x20, 0xF8, 0x20, 0x20, 0x28, 0x10,  // 't'
+  0x00, 0x00, 0x88, 0x88, 0x88, 0x88, 0x70,  // 'u'
+  0x00, 0x00, 0x88, 0x88, 0x88, 0x50, 0x20,  // 'v'
+  0x00, 0x00, 0x88, 0x88, 0xA8, 0xA8, 0x50,  // 'w'
+  0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88,  // 'x'
+  0x00, 0x00, 0x88, 0x88, 0x78, 0x08, 0x70,  // 'y'
+  0x00, 0x00, 0xF8, 0x10, 0x20, 0x40, 0xF8,  // 'z'
+  0x10, 0x20, 0x20, 0x40, 0x20, 0x20, 0x10,  // '{'
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,  // '|'
+  0x50, 0x00, 0x40, 0x10, 0x20, 0x20, 0x40,  // '}'
+  0x00, 0x00, 0x00, 0xE8, 0xB8, 0x00, 0x00,  // '~'
+};
+static constexpr uint8_t atlas_5x7_advance[] PROGMEM = {
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+  6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+};
+
+// Font5x5Fixed, 0x20..0x7E, 6 rows from 4 above the baseline
+#define FONT_5X5 1
+static constexpr uint8_t atlas_5x5_rows[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00,  // ' '
+  0x80, 0x80, 0x80, 0x00, 0x80, 0x00,  // '!'
+  0xA0, 0x00, 0x00, 0x00, 0x00, 0x00,  // '"'
+  0x50, 0xF0, 0x50, 0xF0, 0x50, 0x00,  // '#'
+  0xF0, 0xA0, 0xF0, 0x50, 0xF0, 0x00,  // '$'
+  0xA0, 0x20, 0x40, 0x80, 0xA0, 0x00,  // '%'
+  0xE0, 0xA0, 0xF0, 0xA0, 0xF0, 0x00,  // '&'
+  0x80, 0x00, 0x00, 0x00, 0x00, 0x00,  // "'"
+  0x40, 0x80, 0x80, 0x80, 0x40, 0x00,  // '('
+  0x80, 0x40, 0x40, 0x40, 0x80, 0x00,  // ')'
+  0x00, 0xA0, 0x40, 0xA0, 0x00, 0x00,  // '*'
+  0x00, 0x40, 0xE0, 0x40, 0x00, 0x00,  // '+'
+  0x00, 0x00, 0x00, 0x80, 0x80, 0x00,  // ','
+  0x00, 0x00, 0xE0, 0x00, 0x00, 0x00,  // '-'
+  0x00, 0x00, 0x00, 0x00, 0x80, 0x00,  // '.'
+  0x00, 0x10, 0x20, 0x40, 0x80, 0x00,  // '/'
+  0x70, 0x90, 0x90, 0x90, 0xE0, 0x00,  // '0'
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x00,  // '1'
+  0xF0, 0x10, 0xF0, 0x80, 0xF0, 0x00,  // '2'
+  0xF0, 0x10, 0x70, 0x10, 0xF0, 0x00,  // '3'
+  0x90, 0x90, 0xF0, 0x10, 0x10, 0x00,  // '4'
+  0xF0, 0x80, 0xE0, 0x10, 0xE0, 0x00,  // '5'
+  0xF0, 0x80, 0xF0, 0x90, 0xF0, 0x00,  // '6'
+  0xF0, 0x10, 0x20, 0x40, 0x40, 0x00,  // '7'
+  0xF0, 0x90, 0xF0, 0x90, 0xF0, 0x00,  // '8'
+  0xF0, 0x90, 0xF0, 0x10, 0xF0, 0x00,  // '9'
+  0x00, 0x80, 0x00, 0x80, 0x00, 0x00,  // ':'
+  0x00, 0x80, 0x00, 0x80, 0x80, 0x00,  // ';'
+  0x20, 0x40, 0x80, 0x40, 0x20, 0x00,  // '<'
+  0x00, 0xE0, 0x00, 0xE0, 0x00, 0x00,  // '='
+  0x80, 0x40, 0x20, 0x40, 0x80, 0x00,  // '>'
+  0xE0, 0x10, 0x60, 0x00, 0x40, 0x00,  // '?'
+  0xF0, 0xB0, 0xB0, 0x80, 0xF0, 0x00,  // '@'
+  0x60, 0x90, 0xF0, 0x90, 0x90, 0x00,  // 'A'
+  0xE0, 0x90, 0xE0, 0x90, 0xE0, 0x00,  // 'B'
+  0x70, 0x80, 0x80, 0x80, 0x70, 0x00,  // 'C'
+  0xE0, 0x90, 0x90, 0x90, 0xE0, 0x00,  // 'D'
+  0xF0, 0x80, 0xE0, 0x80, 0xF0, 0x00,  // 'E'
+  0xF0, 0x80, 0xE0, 0x80, 0x80, 0x00,  // 'F'
+  0x70, 0x80, 0xB0, 0x90, 0x60, 0x00,  // 'G'
+  0x90, 0x90, 0xF0, 0x90, 0x90, 0x00,  // 'H'
+  0xE0, 0x40, 0x40, 0x40, 0xE0, 0x00,  // 'I'
+  0x70, 0x20, 0x20, 0xA0, 0x60, 0x00,  // 'J'
+  0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x00,  // 'K'
+  0x80, 0x80, 0x80, 0x80, 0xF0, 0x00,  // 'L'
+  0xF8, 0xA8, 0xA8, 0xA8, 0xA8, 0x00,  // 'M'
+  0xF0, 0x90, 0x90, 0x90, 0x90, 0x00,  // 'N'
+  0x60, 0x90, 0x90, 0x90, 0x60, 0x00,  // 'O'
+  0xE0, 0x90, 0xE0, 0x80, 0x80, 0x00,  // 'P'
+  0xF0, 0x90, 0x90, 0xB0, 0xF0, 0x00,  // 'Q'
+  0xF0, 0x90, 0xF0, 0xA0, 0x90, 0x00,  // 'R'
+  0xF0, 0x80, 0xF0, 0x10, 0xF0, 0x00,  // 'S'
+  0xE0, 0x40, 0x40, 0x40, 0x40, 0x00,  // 'T'
+  0x90, 0x90, 0x90, 0x90, 0xF0, 0x00,  // 'U'
+  0x88, 0x88, 0x88, 0x50, 0x20, 0x00,  // 'V'
+  0xA8, 0xA8, 0xA8, 0xA8, 0xF8, 0x00,  // 'W'
+  0x88, 0x50, 0x20, 0x50, 0x88, 0x00,  // 'X'
+  0x88, 0x88, 0x50, 0x20, 0x20, 0x00,  // 'Y'
+  0xF0, 0x20, 0x40, 0x80, 0xF0, 0x00,  // 'Z'
+  0xC0, 0x80, 0x80, 0x80, 0xC0, 0x00,  // '['
+  0x00, 0x80, 0x40, 0x20, 0x10, 0x00,  // '\\'
+  0xC0, 0x40, 0x40, 0x40, 0xC0, 0x00,  // ']'
+  0x40, 0xA0, 0x00, 0x00, 0x00, 0x00,  // '^'
+  0x00, 0x00, 0x00, 0x00, 0xE0, 0x00,  // '_'
+  0x80, 0x00, 0x00, 0x00, 0x00, 0x00,  // '`'
+  0x00, 0xE0, 0x20, 0xE0, 0xE0, 0x00,  // 'a'
+  0x80, 0x80, 0xC0, 0xA0, 0xE0, 0x00,  // 'b'
+  0x00, 0xE0, 0x80, 0x80, 0xE0, 0x00,  // 'c'
+  0x20, 0x20, 0x60, 0xA0, 0xE0, 0x00,  // 'd'
+  0x00, 0xE0, 0xE0, 0x80, 0xE0, 0x00,  // 'e'
+  0x60, 0x40, 0xE0, 0x40, 0x40, 0x00,  // 'f'
+  0x00, 0xE0, 0xE0, 0x20, 0xE0, 0x00,  // 'g'
+  0x80, 0x80, 0xE0, 0xA0, 0xA0, 0x00,  // 'h'
+  0x00, 0x80, 0x80, 0x80, 0x80, 0x00,  // 'i'
+  0x40, 0x40, 0x40, 0x40, 0xC0, 0x00,  // 'j'
+  0x80, 0xA0, 0xC0, 0xA0, 0xA0, 0x00,  // 'k'
+  0x80, 0x80, 0x80, 0x80, 0xC0, 0x00,  // 'l'
+  0x00, 0xF8, 0xA8, 0x88, 0x88, 0x00,  // 'm'
+  0x00, 0xE0, 0xA0, 0xA0, 0xA0, 0x00,  // 'n'
+  0x00, 0x40, 0xA0, 0xA0, 0x40, 0x00,  // 'o'
+  0x00, 0xE0, 0xE0, 0x80, 0x80, 0x00,  // 'p'
+  0x00, 0xE0, 0xE0, 0x20, 0x20, 0x00,  // 'q'
+  0x00, 0xE0, 0x80, 0x80, 0x80, 0x00,  // 'r'
+  0x00, 0xE0, 0x80, 0x60, 0xE0, 0x00,  // 's'
+  0x40, 0xE0, 0x40, 0x40, 0x40, 0x00,  // 't'
+  0x00, 0xA0, 0xA0, 0xA0, 0xE0, 0x00,  // 'u'
+  0x00, 0xA0, 0xA0, 0xA0, 0x40, 0x00,  // 'v'
+  0x00, 0x88, 0x88, 0xA8, 0xF8, 0x00,  // 'w'
+  0x00, 0x90, 0x60, 0x60, 0x90, 0x00,  // 'x'
+  0x00, 0xA0, 0xE0, 0x40, 0x40, 0x00,  // 'y'
+  0x00, 0xF0, 0x20, 0x40, 0xF0, 0x00,  // 'z'
+  0x20, 0x40, 0xC0, 0x40, 0x20, 0x00,  // '{'
+  0x80, 0x80, 0x80, 0x80, 0x80, 0x00,  // '|'
+  0x80, 0x40, 0x60, 0x40, 0x80, 0x00,  // '}'
+  0x00, 0x00, 0xE8, 0xB8, 0x00, 0x00,  // '~'
+};
+static constexpr uint8_t atlas_5x5_advance[] PROGMEM = {
+  3, 2, 4, 5, 5, 4, 5, 2, 3, 3, 4, 4, 2, 4, 2, 5,
+  5, 2, 5, 5, 5, 5, 5, 5, 5, 5, 2, 2, 4, 4, 4, 5,
+  5, 5, 5, 5, 5, 5, 5, 5, 5, 4, 5, 5, 5, 6, 5, 6,
+  5, 5, 5, 6, 6, 5, 6, 6, 6, 6, 5, 3, 5, 3, 4, 4,
+  2, 4, 4, 4, 4, 4, 4, 4, 4, 2, 3, 4, 3, 6, 4, 4,
+  4, 4, 4, 4, 4, 4, 4, 6, 5, 4, 5, 4, 2, 4, 6,
+};
+
+// Font3x5FixedNum, 0x26..0x3C, 5 rows from 5 above the baseline
+#define FONT_3X5_NUM 2
+static constexpr uint8_t atlas_3x5_num_rows[] PROGMEM = {
+  0xE0, 0xA0, 0xA0, 0xA0, 0xE0,  // '&'
+  0x40, 0x40, 0x40, 0x40, 0x40,  // "'"
+  0xE0, 0x20, 0xE0, 0x80, 0xE0,  // '('
+  0xE0, 0x20, 0xE0, 0x20, 0xE0,  // ')'
+  0xA0, 0xA0, 0xE0, 0x20, 0x20,  // '*'
+  0xE0, 0x80, 0xE0, 0x20, 0xE0,  // '+'
+  0xE0, 0x80, 0xE0, 0xA0, 0xE0,  // ','
+  0xE0, 0x20, 0x20, 0x20, 0x20,  // '-'
+  0xE0, 0xA0, 0xE0, 0xA0, 0xE0,  // '.'
+  0xE0, 0xA0, 0xE0, 0x20, 0xE0,  // '/'
+  0x60, 0xA0, 0xA0, 0xA0, 0xC0,  // '0'
+  0x40, 0xC0, 0x40, 0x40, 0xE0,  // '1'
+  0xC0, 0x20, 0x40, 0x80, 0xE0,  // '2'
+  0xC0, 0x20, 0x40, 0x20, 0xC0,  // '3'
+  0x80, 0xA0, 0xE0, 0x20, 0x20,  // '4'
+  0xE0, 0x80, 0xC0, 0x20, 0xC0,  // '5'
+  0x60, 0x80, 0xC0, 0xA0, 0x40,  // '6'
+  0xE0, 0x20, 0x40, 0x80, 0x80,  // '7'
+  0x40, 0xA0, 0x40, 0xA0, 0x40,  // '8'
+  0x40, 0xA0, 0x60, 0x20, 0xC0,  // '9'
+  0x00, 0x80, 0x00, 0x80, 0x00,  // ':'
+  0x00, 0x80, 0x00, 0x80, 0x80,  // ';'
+  0x00, 0x00, 0x00, 0x00, 0x80,  // '<'
+};
+static constexpr uint8_t atlas_3x5_num_advance[] PROGMEM = {
+  4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+  4, 4, 4, 4, 2, 2, 2,
+};
+
+// Font2x5FixedMonoNum, 0x30..0x3A, 5 rows from 5 above the baseline
+#define FONT_2X5_NUM 3
+static constexpr uint8_t atlas_2x5_num_rows[] PROGMEM = {
+  0xC0, 0xC0, 0xC0, 0xC0, 0xC0,  // '0'
+  0x40, 0x40, 0x40, 0x40, 0x40,  // '1'
+  0xC0, 0x40, 0xC0, 0x80, 0xC0,  // '2'
+  0xC0, 0x40, 0xC0, 0x40, 0xC0,  // '3'
+  0x80, 0x80, 0xC0, 0x40, 0x40,  // '4'
+  0xC0, 0x80, 0xC0, 0x40, 0xC0,  // '5'
+  0x80, 0x80, 0xC0, 0xC0, 0xC0,  // '6'
+  0xC0, 0x40, 0x40, 0x40, 0x40,  // '7'
+  0xC0, 0xC0, 0x00, 0xC0, 0xC0,  // '8'
+  0xC0, 0xC0, 0xC0, 0x40, 0x40,  // '9'
+  0x00, 0x40, 0x00, 0x40, 0x00,  // ':'
+};
+static constexpr uint8_t atlas_2x5_num_advance[] PROGMEM = {
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+};
+
+typedef struct {
+  const uint8_t *rows;
+  const uint8_t *advance;
+  uint8_t first;
+  uint8_t last;
+  uint8_t height;
+  int8_t top;
+} atlas_font;
+
+static const atlas_font atlas_fonts[] PROGMEM = {
+  { atlas_5x7_rows, atlas_5x7_advance, 0x20, 0x7E, 7, -7 },
+  { atlas_5x5_rows, atlas_5x5_advance, 0x20, 0x7E, 6, -4 },
+  { atlas_3x5_num_rows, atlas_3x5_num_advance, 0x26, 0x3C, 5, -5 },
+  { atlas_2x5_num_rows, atlas_2x5_num_advance, 0x30, 0x3A, 5, -5 },
+};
+
+// Advance of c in pixels, 0 when the font has no such glyph. Only for
+// constant expressions: at run time the tables must be read from flash.
+constexpr uint8_t atlas_advance(uint8_t font, char c) {
+  return
+    font == FONT_5X7 ? (c >= 0x20 && c <= 0x7E ? atlas_5x7_advance[c - 0x20] : 0) :
+    font == FONT_5X5 ? (c >= 0x20 && c <= 0x7E ? atlas_5x5_advance[c - 0x20] : 0) :
+    font == FONT_3X5_NUM ? (c >= 0x26 && c <= 0x3C ? atlas_3x5_num_advance[c - 0x26] : 0) :
+    font == FONT_2X5_NUM ? (c >= 0x30 && c <= 0x3A ? atlas_2x5_num_advance[c - 0x30] : 0) :
+    0;
+}
+
+#endif
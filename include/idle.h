@@ -0,0 +1,27 @@
+#ifndef IDLE_H
+#define IDLE_H
+
+#include <Arduino.h>
+
+/**
+ * Idle sleep between loop() passes. The CPU halts until the next interrupt:
+ * the panel refresh (Timer1), millis() or the button sampling (Timer0).
+ * Timers keep running in idle mode, so the display is not disturbed.
+ *
+ * Time asleep is accumulated over windows of IDLE_REPORT_MS and each window
+ * is reported through session_idle().
+ */
+
+#define IDLE_REPORT_MS 60000UL
+
+typedef struct {
+  unsigned long window_us;
+  unsigned long asleep_us;
+  unsigned long wakeups;
+} idle_stats;
+
+extern idle_stats idle_window;
+
+void idle_sleep();
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <Arduino.h>
+
+/**
+ * Buttons, sampled together every millisecond from the Timer0 compare B
+ * interrupt with one read of each port (PINC for the arrows, PIND for
+ * turbo, PING for pause) and debounced with a 2-bit vertical counter: a
+ * button changes state after 4 identical samples in a row.
+ *
+ * Screens read the debounced state with input_held() and consume edges
+ * with input_next(); edges are queued so presses landing between two polls
+ * are neither merged nor lost.
+ */
+
+#define BTN_LEFT  0x01
+#define BTN_UP    0x02
+#define BTN_RIGHT 0x04
+#define BTN_DOWN  0x08
+#define BTN_TURBO 0x10
+#define BTN_PAUSE 0x20
+
+#define BTN_ARROWS 0x0F
+#define BTN_ALL    0x3F
+
+#define INPUT_QUEUE_LEN 8
+
+typedef struct {
+  uint8_t button;
+  bool pressed;
+  unsigned long time;
+} input_event;
+
+void input_begin();
+uint8_t input_held();
+bool input_next(input_event &event);
+void input_flush();
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef PANEL_H
+#define PANEL_H
+
+#include <Arduino.h>
+#include <RGBmatrixPanel.h>
+
+/**
+ * Writes into RGBmatrixPanel's back buffer without going through the
+ * virtual drawPixel(). The driver keeps rows y and y + 16 in the same
+ * bytes: every column has one byte in each of three 64-byte plane rows,
+ * holding planes 1..3 of R, G and B in bits 2..4 (top half) or 5..7
+ * (bottom half), with plane 0 spread over the two low bits.
+ *
+ * A colour is turned once into the bits it sets in those three bytes
+ * (panel_ink_for()); drawing a pixel is then three masked stores. Callers
+ * keep the inks of their fixed palette around instead of colours.
+ *
+ * Building with -DPANEL_BENCHMARK=1 runs panel_benchmark() at power-up. It
+ * prints how many pixels per second each primitive and its Adafruit_GFX
+ * counterpart draw, one "B <primitive> <gfx> <direct>" line each, in hex
+ * like the session log.
+ */
+
+#define PANEL_WIDTH 64
+#define PANEL_HEIGHT 32
+
+// Bit planes the refresh interrupt cycles through, the top PANEL_PLANES of
+// the driver's 4; tools/rgbmatrix_planes.py patches the driver to match.
+// Each plane dropped saves one interrupt per row, and dropping plane 0
+// saves the costly one, which unpacks its bits column by column.
+#ifndef PANEL_PLANES
+#define PANEL_PLANES 4
+#endif
+
+#if PANEL_PLANES < 2 || PANEL_PLANES > 4
+#error "PANEL_PLANES must be 2, 3 or 4"
+#endif
+
+#define PANEL_LEVELS ((1 << PANEL_PLANES) - 1)
+
+// A plane is lit twice as long as the one below it, so channel level v out
+// of 15 is as bright as v * PANEL_LEVELS / 15 in the top planes alone. A
+// lit channel never rounds down to off.
+constexpr uint8_t panel_level(uint8_t v) {
+  return (v == 0 ? 0 : (v * PANEL_LEVELS + 7) / 15 == 0 ? 1 : (v * PANEL_LEVELS + 7) / 15) << (4 - PANEL_PLANES);
+}
+
+// RGBmatrixPanel::Color444(), usable in constant expressions.
+constexpr uint16_t panel_color444(uint8_t r, uint8_t g, uint8_t b) {
+  return ((r & 0xF) << 12) | ((r & 0x8) << 8) | ((g & 0xF) << 7) | ((g & 0xC) << 3) | ((b & 0xF) << 1) |
+         ((b & 0x8) >> 3);
+}
+
+// Colour for 4-bit channels as shown with PANEL_PLANES planes, worked out
+// by the compiler.
+constexpr uint16_t panel_color(uint8_t r, uint8_t g, uint8_t b) {
+  return panel_color444(panel_level(r), panel_level(g), panel_level(b));
+}
+
+// With double buffering everything is drawn into the back buffer and
+// panel_present() shows it in one swap at the end of a refresh frame, so no
+// half-drawn screen is ever on the panel. The second buffer takes another
+// 3 KB of the 8 KB of SRAM; -DPANEL_DOUBLE_BUFFER=0 gives it back.
+#ifndef PANEL_DOUBLE_BUFFER
+#define PANEL_DOUBLE_BUFFER 1
+#endif
+
+typedef struct {
+  uint8_t set[2][3];  // [bottom half][plane row]
+} panel_ink;
+
+// Set by every drawing call, direct or through Adafruit_GFX, since the
+// last panel_present().
+extern bool panel_dirty;
+
+void panel_begin(RGBmatrixPanel &panel);
+
+// The driver with drawing through Adafruit_GFX marking the frame dirty. It
+// becomes the target of the direct primitives as soon as it is built, so
+// they work before setup() too, as in a host replay.
+class panel_device : public RGBmatrixPanel {
+public:
+  panel_device(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint8_t clk, uint8_t lat, uint8_t oe, uint8_t width)
+      : RGBmatrixPanel(a, b, c, d, clk, lat, oe, PANEL_DOUBLE_BUFFER, width) {
+    panel_begin(*this);
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t c) override {
+    panel_dirty = true;
+    RGBmatrixPanel::drawPixel(x, y, c);
+  }
+
+  void fillScreen(uint16_t c) override {
+    panel_dirty = true;
+    RGBmatrixPanel::fillScreen(c);
+  }
+};
+
+void panel_present();
+panel_ink panel_ink_for(uint16_t color);
+void panel_pixel(int16_t x, int16_t y, const panel_ink &ink);
+void panel_row(int16_t x, int16_t y, uint8_t bits, const panel_ink &ink);
+void panel_row_opaque(int16_t x, int16_t y, uint8_t bits, const panel_ink &ink, const panel_ink &bg);
+void panel_span(int16_t x, int16_t y, int16_t w, const panel_ink &ink);
+void panel_vspan(int16_t x, int16_t y, int16_t h, const panel_ink &ink);
+void panel_fill(int16_t x, int16_t y, int16_t w, int16_t h, const panel_ink &ink);
+void panel_rect(int16_t x, int16_t y, int16_t w, int16_t h, const panel_ink &ink);
+void panel_bitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, const panel_ink &ink);
+
+#ifndef PANEL_BENCHMARK
+#define PANEL_BENCHMARK 0
+#endif
+
+#if PANEL_BENCHMARK
+void panel_benchmark();
+#endif
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <Arduino.h>
+
+/**
+ * Hot-path profiler. Build with -DPROFILE=1 and put PROFILE_ZONE(zone) at
+ * the top of a function: the time from there to the end of the scope is
+ * added to the zone's total, call count and worst case. On every screen
+ * change profile_report() prints what the screen being left spent, one
+ * line per zone over Serial, plus the share of the CPU taken by interrupts
+ * (panel refresh, millis(), buttons), and starts the next screen afresh:
+ *
+ *   Q screen <screen>
+ *   Q <zone> <calls> <total> <worst>
+ *   Q isr <permille> <planes>
+ *
+ * where screen is one of the SCREEN_ numbers in main.cpp and planes is the
+ * PANEL_PLANES the panel is refreshed with.
+ *
+ * Numbers are hex. On the console times are CPU cycles, read from Timer5
+ * running at the CPU clock; on the host they are nanoseconds. Each probe
+ * adds its own overhead of a few dozen cycles. A screen that ran no probe
+ * prints nothing.
+ *
+ * With PROFILE 0 the probes and calls compile to nothing.
+ */
+
+#ifndef PROFILE
+#define PROFILE 0
+#endif
+
+#define PROF_TICK 0
+#define PROF_MOVE 1
+#define PROF_COLLIDE 2
+#define PROF_DRAW 3
+#define PROF_FOOD 4
+#define PROF_TEXT 5
+#define PROF_FILL 6
+#define PROF_ZONES 7
+
+#if PROFILE
+uint32_t profile_now();
+void profile_add(uint8_t zone, uint32_t start);
+void profile_begin();
+void profile_report(uint8_t screen);
+
+struct profile_scope {
+  uint8_t zone;
+  uint32_t start;
+  profile_scope(uint8_t z) : zone(z), start(profile_now()) {}
+  ~profile_scope() { profile_add(zone, start); }
+};
+
+#define PROFILE_ZONE(zone) profile_scope profile_scope_(zone)
+#else
+#define PROFILE_ZONE(zone)
+inline void profile_begin() {}
+inline void profile_report(uint8_t) {}
+#endif
+
+#endif
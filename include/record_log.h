@@ -0,0 +1,54 @@
+#ifndef RECORD_LOG_H
+#define RECORD_LOG_H
+
+#include <Arduino.h>
+#include "score_codec.h"
+
+/**
+ * Append-only log of records spread over the whole EEPROM, so repeated
+ * saves wear every cell evenly instead of one fixed block.
+ *
+ * The space after LOG_START is cut into LOG_SLOTS slots of LOG_SLOT_LEN
+ * bytes, each holding one record:
+ *
+ *   seq (2)  crc (2)  payload (up to LOG_PAYLOAD_LEN)
+ *
+ * Appends go to the slot after the current one with the next sequence
+ * number, through the background writer (eeprom_store.h), which writes the
+ * slot from its end so the header lands last. log_mount() reads only the
+ * slot headers to find the newest sequence number, then steps back over
+ * records whose CRC fails (a write cut off by a power loss) - at most
+ * LOG_SLOTS checks.
+ */
+
+#define LOG_START 8
+#define LOG_HEADER_LEN 4
+
+// A slot holds the high score boards of every mode, so it follows
+// NUM_HI_SCORES. It is never shorter than the 96 bytes of the default
+// tables, which keeps their EEPROM layout.
+#define LOG_SLOT_MIN 96
+#ifndef LOG_SLOT_LEN
+#define LOG_SLOT_LEN (LOG_HEADER_LEN + SCORES_PACKED_MAX > LOG_SLOT_MIN ? LOG_HEADER_LEN + SCORES_PACKED_MAX : LOG_SLOT_MIN)
+#endif
+#define LOG_PAYLOAD_LEN (LOG_SLOT_LEN - LOG_HEADER_LEN)
+#define LOG_SLOTS ((4096 - LOG_START) / LOG_SLOT_LEN)
+#define LOG_ERASED 0xFFFF
+
+#if LOG_SLOT_LEN > 255
+#error "LOG_SLOT_LEN is limited to 255 bytes: lower NUM_HI_SCORES"
+#endif
+
+void log_format();
+bool log_mount();
+bool log_read(void *data, uint8_t len);
+// Reads the newest record of a log written with slots of another length,
+// without mounting it; log_format() it before appending.
+bool log_read_legacy(uint8_t slot_len, void *data, uint8_t len);
+// Appends the len payload bytes the caller has put at record +
+// LOG_HEADER_LEN of a LOG_SLOT_LEN buffer; the header is filled in here.
+// The background writer reads the buffer in place, so it has to stay
+// unchanged until store_busy() turns false.
+void log_append(uint8_t record[], uint8_t len);
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef SCORE_CODEC_H
+#define SCORE_CODEC_H
+
+#include <Arduino.h>
+
+/**
+ * High score tables and their packed form in EEPROM.
+ *
+ * Names only use the NAME_LETTERS symbols of name_letters[], so each
+ * character is stored as a 7-bit index (NAME_END pads short names).
+ * Tables are sorted, so each score is stored as its distance to the score
+ * above it, in one or two bytes: 7 bits and a flag, then the 8 bits above
+ * those when the flag is set. Scores stay below SCORE_MAX, so two bytes
+ * always do.
+ *
+ *   boards (8 bits)
+ *   per board: count (1 byte), then per entry 6 x 7-bit name, score (1-2 bytes)
+ *
+ * An entry takes 50 bits when it is within 127 points of the one above and
+ * 58 otherwise, against 64 unpacked. The boards of all game modes share one
+ * record.
+ */
+
+#define NAME_LEN 6
+#ifndef NUM_HI_SCORES
+#define NUM_HI_SCORES 10
+#endif
+
+#define MODE_CLASSIC 0
+#define NUM_MODES 1
+
+#define NAME_LETTERS 69
+#define NAME_END 127
+
+#define SCORE_MAX 0x7FFF
+
+// Worst case: every score taking two bytes.
+#define PACKED_ENTRY_MAX_BITS (NAME_LEN * 7 + 16)
+#define SCORES_PACKED_MAX (1 + NUM_MODES * (1 + (NUM_HI_SCORES * PACKED_ENTRY_MAX_BITS + 7) / 8))
+
+typedef struct {
+  char name[NAME_LEN] = {'\0'};
+  uint16_t points = 0;
+} highscore_entry;
+
+typedef struct {
+  uint8_t version = 1;
+  highscore_entry scores[NUM_HI_SCORES];
+} highscores;
+
+extern const char name_letters[NAME_LETTERS] PROGMEM;
+
+uint8_t scores_pack(const highscores boards[], uint8_t count, uint8_t *out, uint8_t len);
+bool scores_unpack(const uint8_t *in, uint8_t len, highscores boards[], uint8_t count);
+
+#endif
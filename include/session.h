@@ -0,0 +1,50 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <Arduino.h>
+
+/**
+ * Session log: the seed of every game plus a tick-indexed stream of the
+ * inputs and state checksums, written over Serial so a field session can
+ * be re-simulated on the host with session_replay().
+ *
+ *   S <seed>                  game started with randomSeed(seed)
+ *   I <tick> <events>         before the tick: U/R/D/L direction change,
+ *                             T turbo, P pause toggled
+ *   C <tick> <crc>            rolling state checksum after the tick
+ *   E <tick> <crc> <points>   game ended on the tick
+ *   J <ticks> <min> <p50> <p99> <max> <resyncs>
+ *                             tick jitter in us since power-up
+ *   Z <ms> <asleep_ms> <wakeups>
+ *                             idle sleep over the last report window
+ *
+ * Numbers are hex. Only directions affect the game state; turbo and pause
+ * change the pace and are logged for reference.
+ */
+
+#ifndef SESSION_LOG
+#define SESSION_LOG 1
+#endif
+
+#define SESSION_BAUD 115200
+#define SESSION_CHECK_EVERY 64
+
+#if SESSION_LOG
+void session_begin(unsigned long seed);
+void session_input(unsigned long tick, int dir, bool turbo, bool pause_toggled);
+void session_tick(unsigned long tick, uint8_t state);
+void session_timing();
+void session_idle(unsigned long window_ms, unsigned long asleep_ms, unsigned long wakeups);
+#else
+inline void session_begin(unsigned long) {}
+inline void session_input(unsigned long, int, bool, bool) {}
+inline void session_tick(unsigned long, uint8_t) {}
+inline void session_timing() {}
+inline void session_idle(unsigned long, unsigned long, unsigned long) {}
+#endif
+
+#ifndef __AVR__
+int session_replay(const char *path);
+#endif
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TEXT_H
+#define TEXT_H
+
+#include <Arduino.h>
+#include "glyph_atlas.h"
+
+/**
+ * Text from the pre-rasterized glyph atlas (glyph_atlas.h, generated by
+ * tools/gen_glyph_atlas.py). Every glyph row is one byte that goes straight
+ * into the panel buffer through panel_row(); nothing is decoded, measured
+ * or allocated at run time.
+ *
+ * Coordinates follow Adafruit_GFX custom fonts: x is the left edge of the
+ * first glyph and y its baseline. The background is left untouched.
+ * FONT_5X7 stands in for the built-in font, whose cursor sits 7 rows
+ * above that baseline. It is a different face, though: the console's
+ * glcdfont hangs 'g' into an eighth row and draws 't' with another top
+ * row, so the points screen does not look exactly as it did with the
+ * built-in font. The host HAL draws the built-in font with the same
+ * Font5x7FixedMono, so host frames do not show the difference.
+ */
+
+// Width of a string literal, worked out by the compiler; use TEXT_WIDTH().
+constexpr uint8_t text_width(uint8_t font, const char *text) {
+  return *text ? atlas_advance(font, *text) + text_width(font, text + 1) : 0;
+}
+
+template <uint8_t width> struct text_constant {
+  enum { value = width };
+};
+
+#define TEXT_WIDTH(font, text) ((uint8_t)text_constant<text_width(font, text)>::value)
+
+int16_t text_draw(uint8_t font, int16_t x, int16_t y, const char *text, uint16_t color);
+int16_t text_draw_P(uint8_t font, int16_t x, int16_t y, PGM_P text, uint16_t color);
+int16_t text_draw_number(uint8_t font, int16_t x, int16_t y, uint16_t number, uint16_t color);
+uint8_t text_number_width(uint8_t font, uint16_t number);
+uint8_t text_glyph_row(uint8_t font, char c, int8_t row);
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TICK_CLOCK_H
+#define TICK_CLOCK_H
+
+#include <Arduino.h>
+
+/**
+ * Fixed-timestep clock for the game ticks. Each deadline is the previous
+ * one plus the period, so time spent drawing a tick does not push the next
+ * one back. All comparisons are done on the difference of two unsigned
+ * readings, which stays correct across the micros() rollover.
+ *
+ * Every tick records how late it ran (its jitter) into tick_jitter:
+ * min/max and a histogram of TICK_JITTER_STEP_US wide buckets that
+ * tick_jitter_percentile() reads.
+ */
+
+#define TICK_JITTER_BUCKETS 32
+#define TICK_JITTER_STEP_US 250
+// Further behind than this many periods, the clock drops the missed
+// ticks and restarts from now instead of running them back to back.
+#define TICK_MAX_LAG 4
+
+typedef struct {
+  unsigned long ticks;
+  unsigned long resyncs;
+  unsigned long min_us;
+  unsigned long max_us;
+  uint16_t histogram[TICK_JITTER_BUCKETS];
+} tick_stats;
+
+extern tick_stats tick_jitter;
+
+void tick_start(unsigned long period_us);
+bool tick_due();
+void tick_schedule(unsigned long period_us);
+void tick_hold(unsigned long period_us);
+unsigned long tick_jitter_percentile(uint8_t percent);
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef NATIVE_HAL_EEPROM_H
+#define NATIVE_HAL_EEPROM_H
+
+/**
+ * File-backed EEPROM for the host build. The image lives in the file
+ * given by --eeprom (eeprom.bin by default) and starts erased (0xFF).
+ */
+
+#include "Arduino.h"
+
+#define EEPROM_SIZE 4096
+
+class EEPROMClass {
+public:
+  uint8_t read(int idx);
+  void write(int idx, uint8_t val);
+  void update(int idx, uint8_t val) { if (read(idx) != val) write(idx, val); }
+  uint16_t length() const { return EEPROM_SIZE; }
+
+  template <typename T> T &get(int idx, T &t) {
+    uint8_t *p = (uint8_t *)&t;
+    for (unsigned int i = 0; i < sizeof(T); i++) p[i] = read(idx + i);
+    return t;
+  }
+  template <typename T> const T &put(int idx, const T &t) {
+    const uint8_t *p = (const uint8_t *)&t;
+    for (unsigned int i = 0; i < sizeof(T); i++) update(idx + i, p[i]);
+    return t;
+  }
+
+  unsigned long writes = 0;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
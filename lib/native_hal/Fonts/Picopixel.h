@@ -0,0 +1,9 @@
+#ifndef NATIVE_HAL_PICOPIXEL_H
+#define NATIVE_HAL_PICOPIXEL_H
+
+// Picopixel ships with Adafruit GFX, which the host build does not pull
+// in. The closest bundled font stands in for it.
+#include "Font4x5Fixed.h"
+#define Picopixel Font4x5Fixed
+
+#endif
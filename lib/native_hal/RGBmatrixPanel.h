@@ -0,0 +1,37 @@
+#ifndef NATIVE_HAL_RGBMATRIXPANEL_H
+#define NATIVE_HAL_RGBMATRIXPANEL_H
+
+/**
+ * Stand-in for the Adafruit RGBmatrixPanel driver. Pixels are kept in the
+ * driver's own bit-plane layout (see drawPixel() in gfx.cpp) so code that
+ * writes backBuffer() directly draws the same picture as on the console;
+ * getPixel() decodes the shown buffer back to Color444 for
+ * hal_dump_frame(). swapBuffers() swaps at once instead of waiting for the
+ * end of a refresh frame.
+ */
+
+#include "Adafruit_GFX.h"
+
+class RGBmatrixPanel : public Adafruit_GFX {
+public:
+  RGBmatrixPanel(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint8_t clk,
+                 uint8_t lat, uint8_t oe, bool dbuf, uint8_t width = 32);
+
+  void begin() {}
+  void drawPixel(int16_t x, int16_t y, uint16_t c) override;
+  void fillScreen(uint16_t c) override;
+  uint16_t Color333(uint8_t r, uint8_t g, uint8_t b);
+  uint16_t Color444(uint8_t r, uint8_t g, uint8_t b);
+  uint16_t getPixel(int16_t x, int16_t y) const;
+  void swapBuffers(bool copy = true);
+  uint8_t *backBuffer() { return matrixbuf[dbuf ? 1 - front : front]; }
+
+  unsigned long pixel_writes = 0;
+
+private:
+  bool dbuf;
+  uint8_t front = 0;
+  uint8_t matrixbuf[2][64 * 16 * 3];
+};
+
+#endif
@@ -0,0 +1,294 @@
+#include <Adafruit_GFX.h>
+#include <RGBmatrixPanel.h>
+#include "hal.h"
+
+#include "Font5x7FixedMono.h"
+
+// The built-in font is 6x8 per cell with glyphs hanging from the cursor;
+// Font5x7FixedMono glyphs sit on a baseline 7 rows below that. It is close
+// to glcdfont but not the same, so text drawn either way looks alike here.
+#define CLASSIC_BASELINE 7
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) {
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+  for (int16_t j = 0; j < h; j++, y++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (i & 7) b <<= 1;
+      else b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+      if (b & 0x80) drawPixel(x + i, y, color);
+    }
+  }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+  for (int16_t j = 0; j < h; j++, y++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (i & 7) b <<= 1;
+      else b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+      drawPixel(x + i, y, (b & 0x80) ? color : bg);
+    }
+  }
+}
+
+void Adafruit_GFX::setFont(const GFXfont *f) {
+  gfxFont = f;
+}
+
+static void draw_glyph(Adafruit_GFX *gfx, const GFXfont *font, int16_t x, int16_t y, unsigned char c,
+                       uint16_t color, uint8_t size) {
+  if (c < font->first || c > font->last) return;
+  const GFXglyph *glyph = &font->glyph[c - font->first];
+  const uint8_t *bitmap = font->bitmap;
+  uint16_t bo = glyph->bitmapOffset;
+  uint8_t bits = 0, bit = 0;
+  for (uint8_t yy = 0; yy < glyph->height; yy++) {
+    for (uint8_t xx = 0; xx < glyph->width; xx++) {
+      if (!(bit++ & 7)) bits = bitmap[bo++];
+      if (bits & 0x80) {
+        if (size == 1) {
+          gfx->drawPixel(x + glyph->xOffset + xx, y + glyph->yOffset + yy, color);
+        } else {
+          gfx->fillRect(x + (glyph->xOffset + xx) * size, y + (glyph->yOffset + yy) * size, size, size, color);
+        }
+      }
+      bits <<= 1;
+    }
+  }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+  if (gfxFont != NULL) {
+    draw_glyph(this, gfxFont, x, y, c, color, size);
+    return;
+  }
+  if (bg != color) fillRect(x, y, 6 * size, 8 * size, bg);
+  draw_glyph(this, &Font5x7FixedMono, x, y + CLASSIC_BASELINE * size, c, color, size);
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (gfxFont == NULL) {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize * 8;
+    } else if (c != '\r') {
+      if (wrap && (cursor_x + textsize * 6) > _width) {
+        cursor_x = 0;
+        cursor_y += textsize * 8;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+      cursor_x += textsize * 6;
+    }
+    return 1;
+  }
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize * gfxFont->yAdvance;
+  } else if (c != '\r' && c >= gfxFont->first && c <= gfxFont->last) {
+    const GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+    if (glyph->width > 0 && glyph->height > 0) {
+      if (wrap && (cursor_x + textsize * (glyph->xOffset + glyph->width)) > _width) {
+        cursor_x = 0;
+        cursor_y += textsize * gfxFont->yAdvance;
+      }
+      drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+    }
+    cursor_x += glyph->xAdvance * textsize;
+  }
+  return 1;
+}
+
+void Adafruit_GFX::charBounds(unsigned char c, int16_t *x, int16_t *y, int16_t *minx, int16_t *miny,
+                              int16_t *maxx, int16_t *maxy) {
+  if (gfxFont == NULL) {
+    if (c == '\n') {
+      *x = 0;
+      *y += textsize * 8;
+    } else if (c != '\r') {
+      if (wrap && (*x + textsize * 6) > _width) {
+        *x = 0;
+        *y += textsize * 8;
+      }
+      int16_t x2 = *x + textsize * 6 - 1, y2 = *y + textsize * 8 - 1;
+      if (x2 > *maxx) *maxx = x2;
+      if (y2 > *maxy) *maxy = y2;
+      if (*x < *minx) *minx = *x;
+      if (*y < *miny) *miny = *y;
+      *x += textsize * 6;
+    }
+    return;
+  }
+  if (c == '\n') {
+    *x = 0;
+    *y += textsize * gfxFont->yAdvance;
+  } else if (c != '\r' && c >= gfxFont->first && c <= gfxFont->last) {
+    const GFXglyph *glyph = &gfxFont->glyph[c - gfxFont->first];
+    if (wrap && (*x + (glyph->xOffset + glyph->width) * textsize) > _width) {
+      *x = 0;
+      *y += textsize * gfxFont->yAdvance;
+    }
+    int16_t x1 = *x + glyph->xOffset * textsize, y1 = *y + glyph->yOffset * textsize;
+    int16_t x2 = x1 + glyph->width * textsize - 1, y2 = y1 + glyph->height * textsize - 1;
+    if (x1 < *minx) *minx = x1;
+    if (y1 < *miny) *miny = y1;
+    if (x2 > *maxx) *maxx = x2;
+    if (y2 > *maxy) *maxy = y2;
+    *x += glyph->xAdvance * textsize;
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h) {
+  int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+  while (*str) charBounds((unsigned char)*str++, &x, &y, &minx, &miny, &maxx, &maxy);
+  if (x1) *x1 = maxx >= minx ? minx : x;
+  if (y1) *y1 = maxy >= miny ? miny : y;
+  if (w) *w = maxx >= minx ? maxx - minx + 1 : 0;
+  if (h) *h = maxy >= miny ? maxy - miny + 1 : 0;
+}
+
+void Adafruit_GFX::getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h) {
+  getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
+  buffer = (uint8_t *)calloc(((w + 7) / 8) * h, 1);
+}
+
+GFXcanvas1::~GFXcanvas1() {
+  free(buffer);
+}
+
+void GFXcanvas1::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  uint8_t *ptr = &buffer[(x / 8) + y * ((_width + 7) / 8)];
+  if (color) *ptr |= 0x80 >> (x & 7);
+  else *ptr &= ~(0x80 >> (x & 7));
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+RGBmatrixPanel::RGBmatrixPanel(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, bool dbuf,
+                               uint8_t width)
+    : Adafruit_GFX(width, 32), dbuf(dbuf) {
+  memset(matrixbuf, 0, sizeof(matrixbuf));
+  hal_attach_panel(this);
+}
+
+// Rows y and y + 16 share their bytes: each row owns three bytes per
+// column, one per 64-byte plane row, holding planes 1..3 of R, G and B in
+// bits 2..4 (top half) or 5..7 (bottom half). Plane 0 is spread over the
+// two low bits, exactly as in the driver.
+void RGBmatrixPanel::drawPixel(int16_t x, int16_t y, uint16_t c) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  pixel_writes++;
+  uint8_t r = c >> 12, g = (c >> 7) & 0xF, b = (c >> 1) & 0xF;
+  uint8_t *ptr = &backBuffer()[(y & 15) * _width * 3 + x];
+  if (y < 16) {
+    ptr[_width * 2] &= ~0x03;
+    if (r & 1) ptr[_width * 2] |= 0x01;
+    if (g & 1) ptr[_width * 2] |= 0x02;
+    if (b & 1) ptr[_width] |= 0x01;
+    else ptr[_width] &= ~0x01;
+    for (uint8_t bit = 2; bit < 16; bit <<= 1) {
+      *ptr &= ~0x1C;
+      if (r & bit) *ptr |= 0x04;
+      if (g & bit) *ptr |= 0x08;
+      if (b & bit) *ptr |= 0x10;
+      ptr += _width;
+    }
+  } else {
+    *ptr &= ~0x03;
+    if (r & 1) ptr[_width] |= 0x02;
+    else ptr[_width] &= ~0x02;
+    if (g & 1) *ptr |= 0x01;
+    if (b & 1) *ptr |= 0x02;
+    for (uint8_t bit = 2; bit < 16; bit <<= 1) {
+      *ptr &= ~0xE0;
+      if (r & bit) *ptr |= 0x20;
+      if (g & bit) *ptr |= 0x40;
+      if (b & bit) *ptr |= 0x80;
+      ptr += _width;
+    }
+  }
+}
+
+void RGBmatrixPanel::fillScreen(uint16_t c) {
+  if (c == 0x0000 || c == 0xFFFF) {
+    memset(backBuffer(), c, sizeof(matrixbuf[0]));
+  } else {
+    fillRect(0, 0, _width, _height, c);
+  }
+}
+
+uint16_t RGBmatrixPanel::Color333(uint8_t r, uint8_t g, uint8_t b) {
+  return Color444(r << 1 | r >> 2, g << 1 | g >> 2, b << 1 | b >> 2);
+}
+
+static uint16_t color444(uint8_t r, uint8_t g, uint8_t b) {
+  return ((r & 0xF) << 12) | ((r & 0x8) << 8) | ((g & 0xF) << 7) | ((g & 0xC) << 3) | ((b & 0xF) << 1) |
+         ((b & 0x8) >> 3);
+}
+
+uint16_t RGBmatrixPanel::Color444(uint8_t r, uint8_t g, uint8_t b) {
+  return color444(r, g, b);
+}
+
+uint16_t RGBmatrixPanel::getPixel(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+  const uint8_t *ptr = &matrixbuf[front][(y & 15) * _width * 3 + x];
+  uint8_t r, g, b;
+  if (y < 16) {
+    r = ptr[_width * 2] & 1;
+    g = ptr[_width * 2] >> 1 & 1;
+    b = ptr[_width] & 1;
+  } else {
+    r = ptr[_width] >> 1 & 1;
+    g = ptr[0] & 1;
+    b = ptr[0] >> 1 & 1;
+  }
+  uint8_t shift = y < 16 ? 2 : 5;
+  for (uint8_t plane = 1; plane < 4; plane++) {
+    uint8_t bits = ptr[(plane - 1) * _width] >> shift;
+    r |= (bits & 1) << plane;
+    g |= (bits >> 1 & 1) << plane;
+    b |= (bits >> 2 & 1) << plane;
+  }
+  return color444(r, g, b);
+}
+
+void RGBmatrixPanel::swapBuffers(bool copy) {
+  if (!dbuf) return;
+  front = 1 - front;
+  if (copy) memcpy(matrixbuf[1 - front], matrixbuf[front], sizeof(matrixbuf[0]));
+}
@@ -0,0 +1,344 @@
+#include "hal.h"
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <RGBmatrixPanel.h>
+
+#include <stdio.h>
+#include <time.h>
+#include <vector>
+
+// Cost charged to the virtual clock by calls that would take real time on
+// the console, so that polling loops make progress.
+#define POLL_COST_US 20
+
+struct button_event {
+  uint64_t from_us;
+  uint64_t to_us;
+  uint8_t pin;
+};
+
+static uint64_t now_us = 0;
+static uint64_t until_us = 0;
+static uint64_t epoch_us = 0;
+static uint32_t analog_seed = 1;
+static bool dump = false;
+static const char *ppm_path = NULL;
+static const char *eeprom_path = "eeprom.bin";
+static const char *replay_path = NULL;
+static std::vector<button_event> script;
+static uint8_t eeprom_image[EEPROM_SIZE];
+static bool eeprom_loaded = false;
+static struct timespec started;
+#define MAX_TIMERS 4
+
+struct timer {
+  void (*isr)();
+  uint64_t period_us;
+  uint64_t next_us;
+};
+
+static timer timers[MAX_TIMERS];
+static unsigned int timer_count = 0;
+
+// The panel the game constructed, whatever its class.
+static RGBmatrixPanel *panel = NULL;
+
+void hal_attach_panel(RGBmatrixPanel *target) {
+  panel = target;
+}
+
+static int button_pin(const char *name) {
+  static const struct { const char *name; int pin; } names[] = {
+    {"left", 34}, {"up", 35}, {"right", 36}, {"down", 37}, {"turbo", 38}, {"pause", 39}
+  };
+  for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+    if (strcmp(names[i].name, name) == 0) return names[i].pin;
+  }
+  return atoi(name);
+}
+
+static void load_script(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    fprintf(stderr, "hal: cannot open script %s\n", path);
+    exit(2);
+  }
+  char line[128];
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long at, hold;
+    char name[16];
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%lu %15s %lu", &at, name, &hold) != 3) continue;
+    script.push_back({at * 1000ULL, (at + hold) * 1000ULL, (uint8_t)button_pin(name)});
+  }
+  fclose(f);
+}
+
+void hal_init(int argc, char **argv) {
+  uint64_t until_ms = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) load_script(argv[++i]);
+    else if (strcmp(argv[i], "--until") == 0 && i + 1 < argc) until_ms = strtoull(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--eeprom") == 0 && i + 1 < argc) eeprom_path = argv[++i];
+    else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) analog_seed = strtoul(argv[++i], NULL, 10);
+    else if (strcmp(argv[i], "--dump") == 0) dump = true;
+    else if (strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) ppm_path = argv[++i];
+    else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replay_path = argv[++i];
+    else if (strcmp(argv[i], "--epoch") == 0 && i + 1 < argc) epoch_us = strtoull(argv[++i], NULL, 10) * 1000ULL;
+  }
+  if (until_ms == 0) {
+    until_ms = 10000;
+    for (unsigned int i = 0; i < script.size(); i++) {
+      if (script[i].to_us / 1000 + 2000 > until_ms) until_ms = script[i].to_us / 1000 + 2000;
+    }
+  }
+  until_us = until_ms * 1000ULL;
+  clock_gettime(CLOCK_MONOTONIC, &started);
+}
+
+uint64_t hal_now_us() {
+  return now_us;
+}
+
+static timer *next_timer() {
+  timer *first = NULL;
+  for (unsigned int i = 0; i < timer_count; i++) {
+    if (first == NULL || timers[i].next_us < first->next_us) first = &timers[i];
+  }
+  return first;
+}
+
+void hal_advance_us(uint64_t us) {
+  uint64_t target = now_us + us;
+  for (;;) {
+    timer *t = next_timer();
+    if (t == NULL || t->next_us > target) break;
+    now_us = t->next_us;
+    t->next_us += t->period_us;
+    t->isr();
+  }
+  now_us = target;
+  if (now_us >= until_us) hal_finish();
+}
+
+void hal_dump_frame() {
+  static const char shades[] = " .:-=+*#%@";
+  for (int y = 0; y < 32; y++) {
+    for (int x = 0; x < 64; x++) {
+      uint16_t c = panel->getPixel(x, y);
+      int r = c >> 12, g = (c >> 7) & 0xF, b = (c >> 1) & 0xF;
+      int v = r > g ? (r > b ? r : b) : (g > b ? g : b);
+      fputc(c == 0 ? ' ' : shades[1 + v * 8 / 15], stderr);
+    }
+    fputc('\n', stderr);
+  }
+}
+
+static void write_ppm(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) return;
+  fprintf(f, "P6\n64 32\n255\n");
+  for (int y = 0; y < 32; y++) {
+    for (int x = 0; x < 64; x++) {
+      uint16_t c = panel->getPixel(x, y);
+      uint8_t rgb[3] = {(uint8_t)((c >> 12) * 17), (uint8_t)(((c >> 7) & 0xF) * 17), (uint8_t)(((c >> 1) & 0xF) * 17)};
+      fwrite(rgb, 1, 3, f);
+    }
+  }
+  fclose(f);
+}
+
+void hal_finish() {
+  struct timespec ended;
+  clock_gettime(CLOCK_MONOTONIC, &ended);
+  double wall = (ended.tv_sec - started.tv_sec) + (ended.tv_nsec - started.tv_nsec) / 1e9;
+  if (dump) hal_dump_frame();
+  if (ppm_path != NULL) write_ppm(ppm_path);
+  fprintf(stderr, "hal: %.3f s virtual in %.3f s wall, %lu pixel writes, %lu eeprom writes\n",
+          now_us / 1e6, wall, panel->pixel_writes, EEPROM.writes);
+  fflush(stdout);
+  exit(0);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+unsigned long hal_millis() {
+  return (uint32_t)((epoch_us + now_us) / 1000);
+}
+
+unsigned long millis() {
+  hal_advance_us(POLL_COST_US);
+  return hal_millis();
+}
+
+unsigned long micros() {
+  hal_advance_us(POLL_COST_US);
+  return (uint32_t)(epoch_us + now_us);
+}
+
+void delay(unsigned long ms) {
+  hal_advance_us(ms * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  hal_advance_us(us);
+}
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t, uint8_t) {}
+
+void hal_attach_timer(void (*isr)(), unsigned long period_us) {
+  if (timer_count == MAX_TIMERS) return;
+  timers[timer_count].isr = isr;
+  timers[timer_count].period_us = period_us;
+  timers[timer_count].next_us = now_us + period_us;
+  timer_count++;
+}
+
+void hal_sleep() {
+  timer *t = next_timer();
+  hal_advance_us(t != NULL ? t->next_us - now_us : 1000);
+}
+
+int hal_pin(uint8_t pin) {
+  for (unsigned int i = 0; i < script.size(); i++) {
+    if (script[i].pin == pin && now_us >= script[i].from_us && now_us < script[i].to_us) return LOW;
+  }
+  return HIGH;
+}
+
+int digitalRead(uint8_t pin) {
+  hal_advance_us(POLL_COST_US);
+  return hal_pin(pin);
+}
+
+int analogRead(uint8_t) {
+  analog_seed = analog_seed * 1103515245u + 12345u;
+  return (analog_seed >> 16) & 0x3FF;
+}
+
+// Same generator as avr-libc's random(), so a seed logged on the console
+// reproduces the same game on the host.
+static uint32_t random_state = 1;
+
+static int32_t avr_random() {
+  int32_t x = random_state;
+  if (x == 0) x = 123459876L;
+  int32_t hi = x / 127773L;
+  int32_t lo = x % 127773L;
+  x = 16807L * lo - 2836L * hi;
+  if (x < 0) x += 0x7fffffffL;
+  random_state = x;
+  return x % ((uint32_t)0x7fffffff + 1);
+}
+
+long random(long howbig) {
+  if (howbig == 0) return 0;
+  return (uint32_t)avr_random() % (uint32_t)howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if ((uint32_t)seed != 0) random_state = (uint32_t)seed;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+size_t Print::print(long v, int base) {
+  if (v < 0 && base == DEC) return print('-') + print((unsigned long)-v, base);
+  return print((unsigned long)v, base);
+}
+
+size_t Print::print(unsigned long v, int base) {
+  char buf[8 * sizeof(long) + 1];
+  char *p = &buf[sizeof(buf) - 1];
+  *p = '\0';
+  if (base < 2) base = DEC;
+  do {
+    unsigned long d = v % base;
+    *--p = d < 10 ? '0' + d : 'A' + d - 10;
+    v /= base;
+  } while (v);
+  return write(p);
+}
+
+HardwareSerial Serial;
+
+int HardwareSerial::available() {
+  return 0;
+}
+
+int HardwareSerial::read() {
+  return -1;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (c != '\r') fputc(c, stdout);
+  return 1;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+EEPROMClass EEPROM;
+
+static void load_eeprom() {
+  memset(eeprom_image, 0xFF, sizeof(eeprom_image));
+  FILE *f = fopen(eeprom_path, "rb");
+  if (f != NULL) {
+    size_t n = fread(eeprom_image, 1, sizeof(eeprom_image), f);
+    (void)n;
+    fclose(f);
+  }
+  eeprom_loaded = true;
+}
+
+uint8_t EEPROMClass::read(int idx) {
+  if (!eeprom_loaded) load_eeprom();
+  return eeprom_image[idx % EEPROM_SIZE];
+}
+
+void hal_eeprom_write(int idx, uint8_t val) {
+  if (!eeprom_loaded) load_eeprom();
+  eeprom_image[idx % EEPROM_SIZE] = val;
+  EEPROM.writes++;
+  FILE *f = fopen(eeprom_path, "r+b");
+  if (f == NULL) {
+    f = fopen(eeprom_path, "wb");
+    if (f == NULL) return;
+    fwrite(eeprom_image, 1, sizeof(eeprom_image), f);
+  } else {
+    fseek(f, idx % EEPROM_SIZE, SEEK_SET);
+    fputc(val, f);
+  }
+  fclose(f);
+}
+
+void EEPROMClass::write(int idx, uint8_t val) {
+  hal_eeprom_write(idx, val);
+  // The console blocks ~3.3 ms per byte.
+  hal_advance_us(3300);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+// The test suites under test/ (pio test -e native) bring their own main().
+#ifndef PIO_UNIT_TESTING
+void setup();
+void loop();
+int session_replay(const char *path);
+
+int main(int argc, char **argv) {
+  hal_init(argc, argv);
+  if (replay_path != NULL) return session_replay(replay_path);
+  setup();
+  for (;;) {
+    loop();
+  }
+}
+#endif
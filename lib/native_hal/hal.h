@@ -0,0 +1,46 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+/**
+ * Host-side controls of the native HAL.
+ *
+ * Command line of the native binary:
+ *   --script FILE  button script, one "<ms> <button> <hold_ms>" per line,
+ *                  button is left/up/right/down/turbo/pause or a pin number
+ *   --until MS     stop after MS of virtual time (default: script end + 2 s)
+ *   --eeprom FILE  EEPROM image (default eeprom.bin)
+ *   --seed N       value fed to analogRead(), which seeds the game
+ *   --dump         print the final frame to stderr
+ *   --ppm FILE     write the final frame as a PPM image
+ *   --replay FILE  re-simulate a session log captured from Serial and
+ *                  check its checksums instead of running the console
+ *   --epoch MS     start millis() at MS instead of 0, e.g. 4294960000 to
+ *                  cross the 32-bit rollover a few seconds in
+ */
+
+#include <stdint.h>
+
+void hal_init(int argc, char **argv);
+uint64_t hal_now_us();
+void hal_advance_us(uint64_t us);
+void hal_finish();
+void hal_dump_frame();
+
+// Level of a button pin and the millis() reading at the current virtual
+// time, without the polling cost digitalRead() and millis() charge.
+int hal_pin(uint8_t pin);
+unsigned long hal_millis();
+// Calls isr every period_us of virtual time, standing in for a timer
+// interrupt. Up to four can be attached.
+void hal_attach_timer(void (*isr)(), unsigned long period_us);
+// Idle sleep: jumps the virtual clock to the next timer interrupt.
+void hal_sleep();
+// Programs one EEPROM byte without blocking, as the EE_READY interrupt
+// does on the console.
+void hal_eeprom_write(int idx, uint8_t val);
+
+class RGBmatrixPanel;
+// Called by the panel's constructor; frame dumps read this panel.
+void hal_attach_panel(RGBmatrixPanel *panel);
+
+#endif
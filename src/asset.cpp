@@ -0,0 +1,37 @@
+#include "asset.h"
+#include "panel.h"
+
+void asset_draw(const uint8_t *asset, int16_t x, int16_t y, uint16_t color) {
+  uint8_t width = pgm_read_byte(asset);
+  uint8_t height = pgm_read_byte(asset + 1);
+  bool columns = pgm_read_byte(asset + 2) & ASSET_COLUMNS;
+  const uint8_t *runs = asset + 3;
+  // A run wraps from one line to the next, lines being columns or rows.
+  uint8_t line_len = columns ? height : width;
+  uint8_t lines = columns ? width : height;
+  panel_ink ink = panel_ink_for(color);
+  uint8_t line = 0;
+  uint8_t pos = 0;
+  bool set = false;
+  while (line < lines) {
+    uint8_t run = pgm_read_byte(runs++);
+    while (run > 0 && line < lines) {
+      uint8_t part = line_len - pos;
+      if (run < part) part = run;
+      if (set) {
+        if (columns) {
+          panel_vspan(x + line, y + pos, part, ink);
+        } else {
+          panel_span(x + pos, y + line, part, ink);
+        }
+      }
+      run -= part;
+      pos += part;
+      if (pos == line_len) {
+        pos = 0;
+        line++;
+      }
+    }
+    set = !set;
+  }
+}
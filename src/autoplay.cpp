@@ -0,0 +1,215 @@
+#include "autoplay.h"
+#include "game.h"
+#include "session.h"
+
+#ifndef __AVR__
+#include <time.h>
+#endif
+
+#define FIELD_ROWS 30
+#define CYCLE_ROW_LEN 61
+#define CYCLE_LEN (62*30)
+// Columns 2..62, a whole row of the cycle.
+#define FIELD_COLUMNS (~0ULL >> 1 & ~0ULL << 2)
+
+// The flood spreads through reach[], which the game leaves alone between
+// ticks, over rows reached_first..reached_last. It may only take the free
+// cells of the head..food stretch of the cycle, indices
+// fence_first..fence_last (wrapping past CYCLE_LEN); fence_row() works
+// those out per row, so there is no second bitboard for them.
+static uint8_t reached_first, reached_last;
+static unsigned int fence_first, fence_last;
+static bool searching = false;
+
+// Neighbours of the head the search may pick, best one last.
+static unsigned int candidates[4];
+static unsigned int candidate_dist[4];
+static uint8_t candidate_count = 0;
+static unsigned int next_pos;
+
+static unsigned long games = 0;
+static unsigned long total_points = 0;
+static unsigned long ticks, late, tick_us, total_us, max_us, slice_max_us;
+
+#ifdef __AVR__
+static unsigned long search_now() {
+  return micros();
+}
+#else
+// micros() only follows the virtual clock on the host.
+static unsigned long search_now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+}
+#endif
+
+// Position along the cycle: rows 1..30 alternately left to right and right
+// to left over columns 2..62, ending at (2, 30), then column 1 upwards.
+static unsigned int cycle_index(unsigned int pos) {
+  unsigned int x = GET_X(pos);
+  unsigned int y = GET_Y(pos);
+  if (x == 1) return FIELD_ROWS * CYCLE_ROW_LEN + FIELD_ROWS - y;
+  return (y - 1) * CYCLE_ROW_LEN + (y & 1 ? x - 2 : 62 - x);
+}
+
+static unsigned int cycle_pos(unsigned int index) {
+  unsigned int x = 1;
+  unsigned int y = FIELD_ROWS - (index - FIELD_ROWS * CYCLE_ROW_LEN);
+  if (index < FIELD_ROWS * CYCLE_ROW_LEN) {
+    y = index / CYCLE_ROW_LEN + 1;
+    x = y & 1 ? index % CYCLE_ROW_LEN + 2 : 62 - index % CYCLE_ROW_LEN;
+  }
+  return GET_POS(x, y);
+}
+
+// Steps along the cycle from a to b.
+static unsigned int cycle_dist(unsigned int a, unsigned int b) {
+  unsigned int ia = cycle_index(a);
+  unsigned int ib = cycle_index(b);
+  return ib >= ia ? ib - ia : ib + CYCLE_LEN - ia;
+}
+
+// Cells of row y whose cycle index lies in first..last, which must not
+// wrap around.
+static uint64_t cycle_span(uint8_t y, unsigned int first, unsigned int last) {
+  uint64_t row = 0;
+  unsigned int up = FIELD_ROWS * CYCLE_ROW_LEN + FIELD_ROWS - y;
+  if (up >= first && up <= last) row = 1ULL << 1;
+  unsigned int base = (y - 1) * CYCLE_ROW_LEN;
+  unsigned int start = first > base ? first : base;
+  unsigned int end = last < base + CYCLE_ROW_LEN - 1 ? last : base + CYCLE_ROW_LEN - 1;
+  if (start > end) return row;
+  if (start == base && end == base + CYCLE_ROW_LEN - 1) return row | FIELD_COLUMNS;
+  uint8_t x0 = y & 1 ? start - base + 2 : 62 - (end - base);
+  uint8_t x1 = y & 1 ? end - base + 2 : 62 - (start - base);
+  return row | ((~0ULL >> (63 - x1)) & (~0ULL << x0));
+}
+
+// Walls off everything but the cells after the head up to the food, so
+// every path the search finds runs through cells it may take in turn.
+static void build_fence(unsigned int to_food) {
+  fence_first = (cycle_index(snake_head_pos) + 1) % CYCLE_LEN;
+  fence_last = fence_first + to_food - 1;
+}
+
+// The cells of row y the flood may take, for bitboard_wave(). It only asks
+// for rows 1..30.
+static uint64_t fence_row(uint8_t y) {
+  uint64_t open;
+  if (fence_last < CYCLE_LEN) open = cycle_span(y, fence_first, fence_last);
+  else open = cycle_span(y, fence_first, CYCLE_LEN - 1) | cycle_span(y, 0, fence_last - CYCLE_LEN);
+  uint64_t walls;
+  memcpy(&walls, board + y * 8, sizeof(walls));
+  return open & ~walls;
+}
+
+// The shortcut rule: a neighbour further along the cycle than the next
+// cell may be taken if it is no further than the food and leaves more
+// free cells before the tail than the snake is long, so the body stays in
+// cycle order behind the head.
+static bool shortcut_allowed(unsigned int dist, unsigned int to_food, unsigned int to_tail) {
+  return dist <= to_food && dist + snake_len + snake_grow + AUTOPLAY_SLACK < to_tail;
+}
+
+// Ends the search when the flood has reached a candidate; of those reached
+// in the same wave the one furthest along the cycle wins.
+static void check_candidates() {
+  for (uint8_t i = candidate_count; i-- > 0;) {
+    if (bitboard_test(reach, candidates[i])) {
+      next_pos = candidates[i];
+      searching = false;
+      return;
+    }
+  }
+}
+
+void autoplay_begin() {
+  ticks = 0;
+  late = 0;
+  total_us = 0;
+  max_us = 0;
+  slice_max_us = 0;
+  autoplay_plan();
+}
+
+// Starts the search for the move after the coming tick. The neighbours of
+// the head are candidates when taking them keeps the body in cycle order;
+// the next cell of the cycle always is, and is the move until the search
+// says otherwise.
+void autoplay_plan() {
+  unsigned long start = search_now();
+  tick_us = 0;
+  next_pos = cycle_pos((cycle_index(snake_head_pos) + 1) % CYCLE_LEN);
+  searching = false;
+  if (snake_len * 2 >= CYCLE_LEN) return;
+
+  const int dirs[4] = { DIR_UP, DIR_RIGHT, DIR_DOWN, DIR_LEFT };
+  unsigned int to_tail = cycle_dist(snake_head_pos, snake_tail_pos);
+  unsigned int to_food = cycle_dist(snake_head_pos, food);
+  candidate_count = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    unsigned int pos = snake_head_pos + dirs[i];
+    if (board_test(pos)) continue;
+    unsigned int dist = cycle_dist(snake_head_pos, pos);
+    if (dist > 1 && !shortcut_allowed(dist, to_food, to_tail)) continue;
+    uint8_t j = candidate_count++;
+    for (; j > 0 && candidate_dist[j - 1] > dist; j--) {
+      candidates[j] = candidates[j - 1];
+      candidate_dist[j] = candidate_dist[j - 1];
+    }
+    candidates[j] = pos;
+    candidate_dist[j] = dist;
+  }
+  if (candidate_count > 1 || (candidate_count == 1 && candidates[0] != next_pos)) {
+    build_fence(to_food);
+    bitboard_clear(reach);
+    bitboard_set(reach, food);
+    reached_first = GET_Y(food);
+    reached_last = reached_first;
+    searching = true;
+    check_candidates();
+  }
+  tick_us += search_now() - start;
+}
+
+// One slice of the search, run from the loop while waiting for a tick.
+void autoplay_step() {
+  if (!searching) return;
+  unsigned long start = search_now();
+  for (uint8_t i = 0; i < AUTOPLAY_SLICE_WAVES && searching; i++) {
+    if (bitboard_wave(reach, fence_row, reached_first, reached_last)) check_candidates();
+    else searching = false;
+  }
+  unsigned long slice_us = search_now() - start;
+  if (slice_us > slice_max_us) slice_max_us = slice_us;
+  tick_us += slice_us;
+}
+
+// Direction for the tick that is due now.
+int autoplay_move() {
+  if (searching) {
+    searching = false;
+    late++;
+  }
+  ticks++;
+  total_us += tick_us;
+  if (tick_us > max_us) max_us = tick_us;
+  return (int)(next_pos - snake_head_pos);
+}
+
+void autoplay_end() {
+  games++;
+  total_points += points;
+#if SESSION_LOG
+  const unsigned long fields[] = {
+    games, points, total_points / games, ticks, ticks ? total_us / ticks : 0, max_us, slice_max_us, late
+  };
+  Serial.print('A');
+  for (unsigned int i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+    Serial.print(' ');
+    Serial.print(fields[i], HEX);
+  }
+  Serial.println();
+#endif
+}
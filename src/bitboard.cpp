@@ -0,0 +1,211 @@
+#include "bitboard.h"
+#include "game.h"
+#include "profile.h"
+
+#if BITBOARD_BENCHMARK && !defined(__AVR__)
+#include <time.h>
+#endif
+
+// Rows 0 and 31 and columns 0 and 63 are walls, so nothing spreads off the
+// field and a carry never leaves a row.
+static inline uint64_t free_row(const uint8_t walls[], uint8_t y) {
+  uint64_t row;
+  memcpy(&row, walls + y * 8, sizeof(row));
+  return ~row;
+}
+
+// Extends the seeds over the whole free runs they are in. Added to a run,
+// a seed clears it from there to its end and carries out past it, which
+// marks those cells in one addition. Leftwards the row is spread by
+// doubling steps of 1, 2, 4 ... 32 cells, each over the cells whose whole
+// stretch of that length is free, so a run of any length takes six steps.
+// Seeds must be free.
+static inline uint64_t close_row(uint64_t seeds, uint64_t free) {
+  uint64_t row = seeds | (free & ~(free + seeds));
+  row |= free & (row >> 1);
+  free &= free >> 1;
+  row |= free & (row >> 2);
+  free &= free >> 2;
+  row |= free & (row >> 4);
+  free &= free >> 4;
+  row |= free & (row >> 8);
+  free &= free >> 8;
+  row |= free & (row >> 16);
+  free &= free >> 16;
+  return row | (free & (row >> 32));
+}
+
+void bitboard_clear(uint64_t bits[]) {
+  memset(bits, 0, BITBOARD_ROWS * sizeof(uint64_t));
+}
+
+bool bitboard_test(const uint64_t bits[], unsigned int pos) {
+  return (bits[GET_Y(pos)] >> GET_X(pos)) & 1;
+}
+
+void bitboard_set(uint64_t bits[], unsigned int pos) {
+  bits[GET_Y(pos)] |= 1ULL << GET_X(pos);
+}
+
+void bitboard_free(uint64_t bits[], const uint8_t walls[]) {
+  for (uint8_t y = 0; y < BITBOARD_ROWS; y++) bits[y] = free_row(walls, y);
+}
+
+// One step outwards from the cells in bits, for rows first..last, the rows
+// holding any; the range is widened as the cells spread. Every row takes
+// the old rows above and below, so a step never runs ahead of itself, and
+// keeps the cells of open_row(). False once nothing grows.
+bool bitboard_wave(uint64_t bits[], bitboard_row open_row, uint8_t &first, uint8_t &last) {
+  uint8_t top = first > 1 ? first - 1 : 1;
+  uint8_t bottom = last < BITBOARD_ROWS - 2 ? last + 1 : BITBOARD_ROWS - 2;
+  uint64_t above = bits[top - 1];
+  bool grew = false;
+  for (uint8_t y = top; y <= bottom; y++) {
+    uint64_t row = bits[y];
+    uint64_t next = (row | row << 1 | row >> 1 | above | bits[y + 1]) & open_row(y);
+    above = row;
+    if (next == row) continue;
+    bits[y] = next;
+    grew = true;
+    if (y < first) first = y;
+    if (y > last) last = y;
+  }
+  return grew;
+}
+
+// Takes in what the rows above and below reached. True if the row grew.
+static bool spread_row(uint64_t bits[], const uint8_t walls[], uint8_t y) {
+  uint64_t free = free_row(walls, y);
+  uint64_t seeds = (bits[y - 1] | bits[y + 1]) & free & ~bits[y];
+  if (seeds == 0) return false;
+  bits[y] = close_row(bits[y] | seeds, free);
+  return true;
+}
+
+// Leaves in bits the free cells reachable from the given one and returns
+// how many there are. The cell itself only counts when it is free, so the
+// head's cell gives the room the snake has ahead of it.
+unsigned int bitboard_fill(uint64_t bits[], const uint8_t walls[], unsigned int from) {
+  PROFILE_ZONE(PROF_FILL);
+  bitboard_clear(bits);
+  uint8_t y = GET_Y(from);
+  uint64_t start = 1ULL << GET_X(from);
+  uint64_t free = free_row(walls, y);
+  bits[y] = close_row((start | start << 1 | start >> 1) & free, free);
+  free = free_row(walls, y - 1);
+  bits[y - 1] = close_row(start & free, free);
+  free = free_row(walls, y + 1);
+  bits[y + 1] = close_row(start & free, free);
+
+  // Each pass carries the fill as far down (or up) as it goes; it is done
+  // after a pass that adds nothing.
+  for (bool down = true;; down = !down) {
+    bool grew = false;
+    for (uint8_t i = 1; i < BITBOARD_ROWS - 1; i++) {
+      if (spread_row(bits, walls, down ? i : BITBOARD_ROWS - 1 - i)) grew = true;
+    }
+    if (!grew) break;
+  }
+  return bitboard_count(bits, GET_POS(0, 0), GET_POS(63, 31));
+}
+
+// Bits of row y between two positions in reading order.
+static uint64_t range_row(const uint64_t bits[], uint8_t y, unsigned int first, unsigned int last) {
+  uint8_t x0 = y == GET_Y(first) ? GET_X(first) : 0;
+  uint8_t x1 = y == GET_Y(last) ? GET_X(last) : 63;
+  return bits[y] & (~0ULL >> (63 - x1)) & (~0ULL << x0);
+}
+
+unsigned int bitboard_count(const uint64_t bits[], unsigned int first, unsigned int last) {
+  unsigned int count = 0;
+  for (uint8_t y = GET_Y(first); y <= GET_Y(last); y++) {
+    count += __builtin_popcountll(range_row(bits, y, first, last));
+  }
+  return count;
+}
+
+// Position of the n-th set bit between two positions, 0 if there is none.
+unsigned int bitboard_nth(const uint64_t bits[], unsigned int first, unsigned int last, unsigned int n) {
+  for (uint8_t y = GET_Y(first); y <= GET_Y(last); y++) {
+    uint64_t row = range_row(bits, y, first, last);
+    unsigned int count = __builtin_popcountll(row);
+    if (n >= count) {
+      n -= count;
+      continue;
+    }
+    for (; n > 0; n--) row &= row - 1;
+    unsigned int x = __builtin_ctzll(row);
+    return GET_POS(x, y);
+  }
+  return 0;
+}
+
+#if BITBOARD_BENCHMARK
+
+#define BENCH_FILLS 8
+
+#ifdef __AVR__
+static unsigned long bench_now() {
+  return micros() * clockCyclesPerMicrosecond();
+}
+#else
+static unsigned long bench_now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000000UL + now.tv_nsec;
+}
+#endif
+
+static void bench_wall(uint8_t walls[], unsigned int x, unsigned int y) {
+  unsigned int pos = GET_POS(x, y);
+  walls[pos >> 3] |= 1 << (pos & 7);
+}
+
+static void bench_run(const __FlashStringHelper *name, uint8_t walls[], uint64_t bits[], unsigned int from) {
+  unsigned int cells = 0;
+  unsigned long start = bench_now();
+  for (uint8_t n = 0; n < BENCH_FILLS; n++) cells = bitboard_fill(bits, walls, from);
+  unsigned long spent = bench_now() - start;
+  Serial.print(F("F "));
+  Serial.print(name);
+  Serial.print(' ');
+  Serial.print(cells, HEX);
+  Serial.print(' ');
+  Serial.println(spent / BENCH_FILLS, HEX);
+}
+
+// Fills three fields from their top left corner, in walls[], which is left
+// with the last one. An open field, then corridors running along the rows
+// and along the columns: the last one turns the fill back and forth on
+// every column, which is the worst case for passes.
+void bitboard_benchmark(uint8_t walls[], uint64_t bits[]) {
+  memset(walls, 0, BOARD_BYTES);
+  for (uint8_t x = 0; x < 64; x++) {
+    bench_wall(walls, x, 0);
+    bench_wall(walls, x, 31);
+  }
+  for (uint8_t y = 1; y < 31; y++) {
+    bench_wall(walls, 0, y);
+    bench_wall(walls, 63, y);
+  }
+  bench_run(F("open"), walls, bits, GET_POS(1, 1));
+
+  for (uint8_t y = 2; y < 30; y += 2) {
+    for (uint8_t x = 1; x < 63; x++) {
+      if (x != (y % 4 == 2 ? 62 : 1)) bench_wall(walls, x, y);
+    }
+  }
+  bench_run(F("rows"), walls, bits, GET_POS(1, 1));
+
+  memset(walls + 8, 0, BOARD_BYTES - 16);
+  for (uint8_t y = 1; y < 31; y++) {
+    bench_wall(walls, 0, y);
+    bench_wall(walls, 63, y);
+    for (uint8_t x = 2; x < 62; x += 2) {
+      if (y != (x % 4 == 2 ? 30 : 1)) bench_wall(walls, x, y);
+    }
+  }
+  bench_run(F("cols"), walls, bits, GET_POS(1, 1));
+}
+
+#endif
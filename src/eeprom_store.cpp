@@ -0,0 +1,95 @@
+#include "eeprom_store.h"
+
+#ifdef __AVR__
+#include <avr/eeprom.h>
+#include <avr/interrupt.h>
+#else
+#include <EEPROM.h>
+#include "hal.h"
+#endif
+
+static const uint8_t *shadow = NULL;
+static int store_address = 0;
+// Bytes below the cursor may still differ from the shadow.
+static volatile uint8_t store_cursor = 0;
+
+// CRC-16/ARC, the same polynomial as the session log checksums.
+uint16_t store_crc(uint16_t crc, const void *data, unsigned int len) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  for (unsigned int i = 0; i < len; i++) {
+    crc ^= bytes[i];
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = crc & 1 ? (crc >> 1) ^ 0xA001 : crc >> 1;
+    }
+  }
+  return crc;
+}
+
+#ifdef __AVR__
+
+ISR(EE_READY_vect) {
+  while (store_cursor > 0) {
+    uint8_t i = --store_cursor;
+    uint16_t address = store_address + i;
+    if (eeprom_read_byte((const uint8_t *)address) != shadow[i]) {
+      EEAR = address;
+      EEDR = shadow[i];
+      EECR |= _BV(EEMPE);
+      EECR |= _BV(EEPE);
+      return;
+    }
+  }
+  EECR &= ~_BV(EERIE);
+}
+
+static void store_start() {
+  EECR |= _BV(EERIE);
+}
+
+static void store_stop() {
+  EECR &= ~_BV(EERIE);
+}
+
+#else
+
+// Fires at the pace of EEPROM programming (~3.3 ms per byte).
+static void store_isr() {
+  while (store_cursor > 0) {
+    uint8_t i = --store_cursor;
+    if (EEPROM.read(store_address + i) != shadow[i]) {
+      hal_eeprom_write(store_address + i, shadow[i]);
+      return;
+    }
+  }
+}
+
+static void store_start() {
+  static bool attached = false;
+  if (!attached) hal_attach_timer(store_isr, 3300);
+  attached = true;
+}
+
+static void store_stop() {}
+
+#endif
+
+void store_put(int address, const void *data, uint8_t len) {
+  store_wait();
+  store_stop();
+  shadow = (const uint8_t *)data;
+  store_address = address;
+  store_cursor = len;
+  store_start();
+}
+
+bool store_busy() {
+  return store_cursor > 0;
+}
+
+void store_wait() {
+  while (store_busy()) {
+#ifndef __AVR__
+    hal_sleep();
+#endif
+  }
+}
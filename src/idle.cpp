@@ -0,0 +1,34 @@
+#include "idle.h"
+#include "session.h"
+
+#ifdef __AVR__
+#include <avr/sleep.h>
+#else
+#include "hal.h"
+#endif
+
+idle_stats idle_window = { 0, 0, 0 };
+
+static unsigned long window_start = 0;
+
+void idle_sleep() {
+  unsigned long before = micros();
+#ifdef __AVR__
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  sleep_cpu();
+  sleep_disable();
+#else
+  hal_sleep();
+#endif
+  unsigned long after = micros();
+  idle_window.asleep_us += (uint32_t)(after - before);
+  idle_window.wakeups++;
+  idle_window.window_us = (uint32_t)(after - window_start);
+  if (idle_window.window_us >= IDLE_REPORT_MS * 1000) {
+    session_idle(idle_window.window_us / 1000, idle_window.asleep_us / 1000, idle_window.wakeups);
+    idle_window.asleep_us = 0;
+    idle_window.wakeups = 0;
+    window_start = after;
+  }
+}
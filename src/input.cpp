@@ -0,0 +1,101 @@
+#include "input.h"
+
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#else
+#include "hal.h"
+#endif
+
+// Debounced state, bit set while the button is held.
+static volatile uint8_t held = 0;
+static uint8_t count0 = 0xFF;
+static uint8_t count1 = 0xFF;
+
+// Single producer (the sampling interrupt), single consumer (loop()).
+static input_event queue[INPUT_QUEUE_LEN];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+
+static void queue_push(uint8_t button, bool pressed, unsigned long time) {
+  uint8_t next = (queue_head + 1) % INPUT_QUEUE_LEN;
+  if (next == queue_tail) return;
+  queue[queue_head].button = button;
+  queue[queue_head].pressed = pressed;
+  queue[queue_head].time = time;
+  queue_head = next;
+}
+
+static void input_sample(uint8_t raw, unsigned long time) {
+  uint8_t state = held;
+  uint8_t changed = state ^ raw;
+  count0 = ~(count0 & changed);
+  count1 = count0 ^ (count1 & changed);
+  changed &= count0 & count1;
+  if (changed == 0) return;
+  state ^= changed;
+  held = state;
+  for (uint8_t button = BTN_LEFT; button <= BTN_PAUSE; button <<= 1) {
+    if (changed & button) queue_push(button, state & button, time);
+  }
+}
+
+#ifdef __AVR__
+
+// Pins 34..37 are PC3..PC0, 38 is PD7 and 39 is PG2, all active low.
+static inline uint8_t read_buttons() {
+  uint8_t c = ~PINC;
+  uint8_t d = ~PIND;
+  uint8_t g = ~PING;
+  return ((c >> 3) & BTN_LEFT) | ((c >> 1) & BTN_UP) | ((c << 1) & BTN_RIGHT) | ((c << 3) & BTN_DOWN) |
+         ((d >> 3) & BTN_TURBO) | ((g << 3) & BTN_PAUSE);
+}
+
+// Timer0 already overflows every 1.024 ms for millis(); its compare B
+// match is free and gives the same rate.
+ISR(TIMER0_COMPB_vect) {
+  input_sample(read_buttons(), millis());
+}
+
+void input_begin() {
+  DDRC &= ~0x0F;
+  PORTC |= 0x0F;
+  DDRD &= ~0x80;
+  PORTD |= 0x80;
+  DDRG &= ~0x04;
+  PORTG |= 0x04;
+  OCR0B = 0x80;
+  TIMSK0 |= _BV(OCIE0B);
+}
+
+#else
+
+static const uint8_t button_pins[] = { 34, 35, 36, 37, 38, 39 };
+
+static void sample_isr() {
+  uint8_t raw = 0;
+  for (uint8_t i = 0; i < sizeof(button_pins); i++) {
+    if (hal_pin(button_pins[i]) == LOW) raw |= 1 << i;
+  }
+  input_sample(raw, hal_millis());
+}
+
+void input_begin() {
+  hal_attach_timer(sample_isr, 1024);
+}
+
+#endif
+
+uint8_t input_held() {
+  return held;
+}
+
+bool input_next(input_event &event) {
+  if (queue_tail == queue_head) return false;
+  event = queue[queue_tail];
+  queue_tail = (queue_tail + 1) % INPUT_QUEUE_LEN;
+  return true;
+}
+
+void input_flush() {
+  queue_tail = queue_head;
+}
@@ -2,11 +2,23 @@
 #include <RGBmatrixPanel.h> // Hardware Library
 #include <EEPROM.h>
 
-#include "Font3x5FixedNum.h"
-#include "Font2x5FixedMonoNum.h"
-#include "Font5x5Fixed.h"
 #include <Fonts/Picopixel.h>
 
+#include "game.h"
+#include "session.h"
+#include "input.h"
+#include "tick_clock.h"
+#include "idle.h"
+#include "profile.h"
+#include "eeprom_store.h"
+#include "record_log.h"
+#include "score_codec.h"
+#include "panel.h"
+#include "text.h"
+#include "asset.h"
+#include "assets.h"
+#include "autoplay.h"
+
 /**
  * 2048 Snake
  * by Julian Szulc 2016-2023
@@ -14,9 +26,6 @@
  * https://github.com/Havelock-Vetinari
  */
  
-#define ACTIVATED LOW
-#define DEACTIVATED HIGH
-
 #define CLK 11
 #define LAT 10
 #define OE  9
@@ -25,57 +34,94 @@
 #define C   14
 #define D   15
 
-#define GET_X(p) p%64
-#define GET_Y(p) p/64
-#define GET_POS(x,y) (64*y+x)
-
-#define KEY_PRESSED(key) digitalRead(key)==ACTIVATED
-#define KEY_NOT_PRESSED(key) digitalRead(key)==DEACTIVATED
-
 #define INITIAL_GAME_SPEED 320
 #define MAX_GAME_SPEED 60
 #define LEVEL_UP_EVERY 10
 #define SPEEDUP 20
 #define TURBO_SPEED 30
 
-#define DIR_UP -64
-#define DIR_RIGHT 1
-#define DIR_DOWN 64
-#define DIR_LEFT -1
 
-#define NUM_HI_SCORES 10
-#define NAME_LEN 6
+#define SCREEN_INTRO 0
+#define SCREEN_PLAYING 1
+#define SCREEN_GAME_OVER 2
+#define SCREEN_NAME_ENTRY 3
+#define SCREEN_HIGH_SCORES 4
+#define SCREEN_ATTRACT 5
+
+// Left alone that long on the points screen or the high score table, the
+// console plays a demo game by itself, cut short after ATTRACT_TICKS moves.
+// A score that makes the table keeps the points screen up until its name
+// is entered.
+#define ATTRACT_AFTER 30000
+#define ATTRACT_TICKS 3000
+
+// Corner of the field where draw_live_rank() shows the rank during play.
+#define LIVE_RANK_RIGHT 62
+#define LIVE_RANK_BASELINE 30
 
 const uint8_t eeprom_magic[] = { 0x58, 0xCE };
-const char eeprom_version = 0x01;
+const char eeprom_version = 0x04;
 
-#define HIGH_SCORES_ADDRESS 3
+// v1 kept the table at 3 with no checksum, v2 a CRC-16 at 3 and the table
+// at 5. v3 appends every save to the record log (record_log.h), v4 does
+// the same with the boards of all modes packed (score_codec.h).
+#define HIGH_SCORES_V1_ADDRESS 3
+#define HIGH_SCORES_V2_CRC_ADDRESS 3
+#define HIGH_SCORES_V2_ADDRESS 5
+#define HIGH_SCORES_V3_SLOT_LEN 96
 
-RGBmatrixPanel creoqode(A, B, C, D, CLK, LAT, OE, false, 64);
+// The table of v1 to v3, whatever NUM_HI_SCORES is now.
+#define LEGACY_HI_SCORES 10
+typedef struct {
+  uint8_t version;
+  highscore_entry scores[LEGACY_HI_SCORES];
+} legacy_highscores;
+
+// The panel's 3 KB buffer (two with PANEL_DOUBLE_BUFFER) is the only thing
+// on the heap; large state is packed (the snake ring, the board bitmap).
+panel_device creoqode(A, B, C, D, CLK, LAT, OE, 64);
  
-const int button_left = 34;
-const int button_up = 35;
-const int button_right = 36;
-const int button_down = 37;
-const int button_turbo = 38;
-const int button_pause = 39;
-
-const unsigned int color_logo = creoqode.Color444(1, 2, 1);
-const unsigned int color_border = creoqode.Color444(0, 1, 1);
-const unsigned int color_title = creoqode.Color444(10, 0, 0);
-const unsigned int color_gameover = creoqode.Color444(6, 0, 0);
-const unsigned int color_food = creoqode.Color444(0, 6, 0);
-const unsigned int color_snake_head = creoqode.Color444(7, 0, 2);
-const unsigned int color_snake_even = creoqode.Color444(0, 1, 5);
-const unsigned int color_snake_odd = creoqode.Color444(1, 0, 5);
-const unsigned int color_score_title = creoqode.Color444(0, 2, 0);
-const unsigned int color_score_points = creoqode.Color444(0, 6, 0);
-const unsigned int color_level_mark = creoqode.Color444(4, 0, 0);
+
+const unsigned int color_logo = panel_color(1, 2, 1);
+const unsigned int color_border = panel_color(0, 1, 1);
+const unsigned int color_title = panel_color(10, 0, 0);
+const unsigned int color_gameover = panel_color(6, 0, 0);
+const unsigned int color_food = panel_color(0, 6, 0);
+const unsigned int color_snake_head = panel_color(7, 0, 2);
+const unsigned int color_snake_even = panel_color(0, 1, 5);
+const unsigned int color_snake_odd = panel_color(1, 0, 5);
+const unsigned int color_score_title = panel_color(0, 2, 0);
+const unsigned int color_score_points = panel_color(0, 6, 0);
+const unsigned int color_level_mark = panel_color(4, 0, 0);
+const unsigned int color_trapped = panel_color(7, 3, 0);
+const unsigned int color_live_rank = panel_color(1, 1, 1);
+
+// What the game draws in the play field goes straight into the panel
+// buffer (panel.h) with these.
+const panel_ink ink_black = panel_ink_for(0);
+const panel_ink ink_border = panel_ink_for(color_border);
+const panel_ink ink_food = panel_ink_for(color_food);
+const panel_ink ink_snake_head = panel_ink_for(color_snake_head);
+const panel_ink ink_snake_even = panel_ink_for(color_snake_even);
+const panel_ink ink_snake_odd = panel_ink_for(color_snake_odd);
+const panel_ink ink_level_mark = panel_ink_for(color_level_mark);
+const panel_ink ink_trapped = panel_ink_for(color_trapped);
+const panel_ink ink_live_rank = panel_ink_for(color_live_rank);
 
 unsigned int snake_len = 2;
+unsigned int snake_head = 0;
+unsigned int snake_head_pos = 0;
+unsigned int snake_tail_pos = 0;
+unsigned int snake_grow = 0;
 int snake_direction = 1;
 int snake_next_dir = 1;
+int8_t turn_queue[TURN_QUEUE_LEN];
+uint8_t turn_first = 0;
+uint8_t turn_count = 0;
 unsigned int snake_old_tail = 0;
+uint8_t board[BOARD_BYTES];
+uint64_t reach[BITBOARD_ROWS];
+bool trap_flash = false;
 unsigned int food;
 unsigned long curtime;
 unsigned long game_speed = INITIAL_GAME_SPEED;
@@ -84,593 +130,1001 @@ uint16_t points = 0;
 unsigned int points_factor = 1;
 unsigned int catches = 0;
 
+snake_cell snake[SNAKE_CELLS];
+uint8_t game_state = GAME_RUNNING;
+unsigned long game_ticks = 0;
+bool paused = false;
+bool pause_toggled = false;
+bool turbo = false;
+
+uint8_t screen = SCREEN_INTRO;
+uint8_t screen_step = 0;
+unsigned long screen_deadline = 0;
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
-String enter_name();
+const long name_action_delay = 500;
+const int wheel_x = 8;
+const int wheel_y = 6;
+const int wheel_buff_width = 1;
+const int wheel_char_height = 6;
+const int wheel_glyph_top = 1;
+const int wheel_before_lines = 6;
+const int wheel_after_lines = 7;
+const unsigned int wheel_additional_color = panel_color(0, 2, 0);
+const unsigned int wheel_main_color = panel_color(4, 0, 2);
+const unsigned int wheel_bg_color = panel_color(0, 0, 0);
+const panel_ink wheel_additional_ink = panel_ink_for(wheel_additional_color);
+const panel_ink wheel_main_ink = panel_ink_for(wheel_main_color);
+const panel_ink wheel_bg_ink = panel_ink_for(wheel_bg_color);
 
 typedef struct {
-  char name[NAME_LEN] = {'\0'};
-  uint16_t points = 0;
-} highscore_entry;
+  unsigned long entry_time;
+  int letter_indexes[NAME_LEN];
+  unsigned char name[NAME_LEN+1];
+  int current_letter;
+  int selected_index;
+  int i;
+  int letters_dir;
+  bool scrolling;
+} name_entry;
 
 typedef struct {
-  uint8_t version = 1;
-  highscore_entry scores[NUM_HI_SCORES];
-} highscores;
+  unsigned int found_scores;
+  unsigned int offset;
+  unsigned long scroll_time;
+  unsigned long idle_time;
+} high_scores_view;
+
+name_entry entry;
+high_scores_view view;
 
-void show_high_scores(highscores&);
+void name_entry_begin();
+void draw_name_wheel();
+void name_entry_update();
+void high_scores_begin(highscores&);
+void draw_high_scores_page();
+void high_scores_update();
 
-void register_high_score(String name, uint16_t points, highscores &highscores_table);
+void register_high_score(const char *name, uint16_t points, highscores &highscores_table);
 bool is_high_score_eligable(uint16_t points, highscores &highscores_table);
+unsigned int high_score_rank(uint16_t points, highscores &highscores_table);
+void mount_high_scores(highscores boards[]);
+bool load_v2_high_scores(legacy_highscores &legacy);
+void import_legacy_scores(const legacy_highscores &legacy, highscores &highscores_table);
+void save_high_scores(highscores boards[]);
 
-highscores scores;
+highscores scores[NUM_MODES];
+uint8_t game_mode = MODE_CLASSIC;
 
-void intro();
+// Only a LOG_SLOT_LEN set by hand can fail this; it follows NUM_HI_SCORES.
+static_assert(SCORES_PACKED_MAX <= LOG_PAYLOAD_LEN, "high score boards do not fit LOG_SLOT_LEN");
+static_assert(LOG_SLOT_LEN <= sizeof(reach), "save_high_scores() builds the record in reach[]");
+static_assert(NUM_HI_SCORES < 128, "board sizes are stored as one-byte varints");
+// At most one catch per field cell, at the top points factor.
+static_assert(62UL * 30 * ((INITIAL_GAME_SPEED - MAX_GAME_SPEED) / SPEEDUP + 1) <= SCORE_MAX,
+              "scores do not fit the packed score field");
+
+void enter_screen(uint8_t next);
+void screen_wait(unsigned long duration);
+bool due(unsigned long deadline);
+bool any_key_pressed();
+void intro_update();
+void play_update();
+void game_over_update();
+void attract_update();
 void draw_logo();
 
-void reset_snake(unsigned int snake[]);
-void draw_snake(unsigned int snake[]);
-void put_food(int first, int last, unsigned int snake[]);
-void move_snake(unsigned int snake[]);
+void board_reset();
+bool board_test(unsigned int pos);
+void board_set(unsigned int pos);
+void board_clear(unsigned int pos);
+unsigned int snake_index(unsigned int segment);
+void snake_push_head(snake_cell snake[], int dir);
+void snake_pop_tail(snake_cell snake[]);
+unsigned int snake_towards_head(snake_cell snake[], unsigned int segment, unsigned int pos);
+void reset_snake(snake_cell snake[]);
+const panel_ink &segment_ink(unsigned int index);
+void redraw_snake(snake_cell snake[]);
+void draw_snake();
+bool tail_reachable();
+void draw_trap_warning(bool trapped);
+bool put_food(int first, int last);
+void move_snake(snake_cell snake[]);
 void print_points();
+void draw_live_rank();
 void game_over();
-bool detect_colision(unsigned int snake[]);
-void play_game();
+void game_won();
+bool detect_colision();
  
 void setup() {
   int a1 = analogRead(5) * analogRead(5);
   creoqode.begin();
   randomSeed(analogRead(5)*millis() + a1);
 
-  if (EEPROM.read(0) != eeprom_magic[0] || EEPROM.read(1) != eeprom_magic[1]) {
-    EEPROM.write(0, eeprom_magic[0]);
-    EEPROM.write(1, eeprom_magic[1]);
-    EEPROM.write(2, eeprom_version);
-    EEPROM.put(HIGH_SCORES_ADDRESS, scores);
-  } else {
-    EEPROM.get(HIGH_SCORES_ADDRESS,scores);
-  }
-
-  intro();
+  mount_high_scores(scores);
 
-  creoqode.drawRect(0, 0, 64, 32, color_border);
-  delay(1200);
-  pinMode(button_left, INPUT_PULLUP);
-  pinMode(button_up, INPUT_PULLUP);
-  pinMode(button_right, INPUT_PULLUP);
-  pinMode(button_down, INPUT_PULLUP);
-  pinMode(button_turbo, INPUT_PULLUP);
-  pinMode(button_pause, INPUT_PULLUP);
-  // Serial.begin(9600);
+  input_begin();
+#if SESSION_LOG || PROFILE || PANEL_BENCHMARK || BITBOARD_BENCHMARK
+  Serial.begin(SESSION_BAUD);
+#endif
+#if PANEL_BENCHMARK
+  panel_benchmark();
+#endif
+#if BITBOARD_BENCHMARK
+  store_wait();
+  bitboard_benchmark(board, reach);
+#endif
+  profile_begin();
+  curtime = millis();
+  enter_screen(SCREEN_INTRO);
 }
  
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 
+// Every screen is a state machine stepped from here. None of them blocks:
+// waits are deadlines against millis(), so buttons are polled on each pass
+// and the CPU sleeps until the next interrupt in between. What a pass drew
+// is shown at its end in one buffer swap.
 void loop() {
-  play_game();
-  if (is_high_score_eligable(points, scores)) {
-     String name = enter_name();
-     register_high_score(name, points, scores);
-     EEPROM.put(HIGH_SCORES_ADDRESS, scores);
+  curtime = millis();
+  switch (screen) {
+    case SCREEN_INTRO: intro_update(); break;
+    case SCREEN_PLAYING: play_update(); break;
+    case SCREEN_GAME_OVER: game_over_update(); break;
+    case SCREEN_NAME_ENTRY: name_entry_update(); break;
+    case SCREEN_HIGH_SCORES: high_scores_update(); break;
+    case SCREEN_ATTRACT: attract_update(); break;
   }
-  
-  show_high_scores(scores);
-  delay(125);
+  panel_present();
+  idle_sleep();
 }
 
-void intro() {
-  draw_logo();
-  delay(1500);
-  creoqode.setTextSize(2);
-  creoqode.setCursor(3, 5);
-  creoqode.setTextColor(color_title);
-  creoqode.fillRect(2, 4, 60, 16, 0);
-  if (random(0, 10) > 5) {
-    creoqode.print("Wonsz");
-    delay(2000);
-    creoqode.setTextSize(1);
-    creoqode.fillRect(2, 20, 62, 12, 0);
-    creoqode.setCursor(3, 21);
-    creoqode.print("tududu");
-    delay(750);
-    creoqode.fillRect(2, 20, 62, 12, 0);
-    creoqode.setCursor(25, 24);
-    creoqode.print("tududu");
-    delay(2000);
-  } else {
-    creoqode.print("Snake");
-    delay(2000);
+void enter_screen(uint8_t next) {
+  profile_report(screen);
+  screen = next;
+  screen_step = 0;
+  screen_deadline = curtime;
+  input_flush();
+}
+
+void screen_wait(unsigned long duration) {
+  screen_deadline = curtime + duration;
+}
+
+// Signed difference, so deadlines keep working across the millis() rollover.
+bool due(unsigned long deadline) {
+  return (int32_t)(curtime - deadline) >= 0;
+}
+
+bool any_key_pressed() {
+  input_event event;
+  while (input_next(event)) {
+    if (event.pressed) return true;
   }
-  
-  creoqode.drawRect(0, 0, 64, 32, color_border);
-  delay(1200);
+  return false;
 }
 
-void play_game() {
-  unsigned int snake[62*30];
+void intro_update() {
+  if (screen_step > 0 && any_key_pressed()) {
+    enter_screen(SCREEN_PLAYING);
+    return;
+  }
+  if (!due(screen_deadline)) return;
+  switch (screen_step++) {
+    case 0:
+      draw_logo();
+      screen_wait(1500);
+      break;
+    case 1:
+      creoqode.setTextSize(2);
+      creoqode.setCursor(3, 5);
+      creoqode.setTextColor(color_title);
+      panel_fill(2, 4, 60, 16, ink_black);
+      if (random(0, 10) > 5) {
+        creoqode.print(F("Wonsz"));
+      } else {
+        creoqode.print(F("Snake"));
+        screen_step = 4;
+      }
+      screen_wait(2000);
+      break;
+    case 2:
+      creoqode.setTextSize(1);
+      panel_fill(2, 20, 62, 12, ink_black);
+      creoqode.setCursor(3, 21);
+      creoqode.print(F("tududu"));
+      screen_wait(750);
+      break;
+    case 3:
+      panel_fill(2, 20, 62, 12, ink_black);
+      creoqode.setCursor(25, 24);
+      creoqode.print(F("tududu"));
+      screen_wait(2000);
+      break;
+    case 4:
+      panel_rect(0, 0, 64, 32, ink_border);
+      screen_wait(2400);
+      break;
+    default:
+      enter_screen(SCREEN_PLAYING);
+  }
+}
 
-  randomSeed(analogRead(5)*millis());
-  reset_snake(snake);
-  put_food(GET_POS(31, 15), GET_POS(33, 30), snake);
-  unsigned long next_move = 0;
-  draw_snake(snake);
-  bool paused = false;
-  bool turbo = false;
-  while(true){
-    curtime = millis();
-    if(KEY_PRESSED(button_left)){
-      if(snake_direction != DIR_RIGHT) snake_next_dir = DIR_LEFT;
-    } else if(KEY_PRESSED(button_right)){
-      if(snake_direction != DIR_LEFT) snake_next_dir = DIR_RIGHT;
-    } else if(KEY_PRESSED(button_up)){
-      if(snake_direction != DIR_DOWN) snake_next_dir = DIR_UP;
-    } else if(KEY_PRESSED(button_down)){
-      if(snake_direction != DIR_UP) snake_next_dir = DIR_DOWN;
-    } else if(KEY_PRESSED(button_pause)){
-      paused = !paused;
-      delay(250);
-    } else if(KEY_PRESSED(button_turbo)){
-      turbo = true;
+void play_update() {
+  if(screen_step == 0) {
+    if(!due(screen_deadline)) return;
+    screen_step = 1;
+    start_game(snake, analogRead(5)*millis());
+    tick_start(0);
+    game_ticks = 0;
+    paused = false;
+    pause_toggled = false;
+    turbo = false;
+  }
+  input_event event;
+  while(input_next(event)) {
+    if(!event.pressed) continue;
+    switch(event.button) {
+      case BTN_LEFT: queue_turn(DIR_LEFT); break;
+      case BTN_RIGHT: queue_turn(DIR_RIGHT); break;
+      case BTN_UP: queue_turn(DIR_UP); break;
+      case BTN_DOWN: queue_turn(DIR_DOWN); break;
+      case BTN_PAUSE:
+        paused = !paused;
+        pause_toggled = true;
+        break;
     }
-    if(paused) {
-      delay(100);
-      turbo = false;
-      next_move = curtime + game_speed;
+  }
+  if(input_held() & BTN_TURBO) {
+    turbo = true;
+  }
+  if(paused) {
+    turbo = false;
+    tick_hold(game_speed * 1000UL);
+  }
+  if(tick_due()) {
+    game_state = game_tick(snake);
+    draw_live_rank();
+    session_input(game_ticks, snake_direction, turbo, pause_toggled);
+    pause_toggled = false;
+    session_tick(game_ticks, game_state);
+    game_ticks++;
+    if(game_state != GAME_RUNNING) {
+      session_timing();
+      enter_screen(SCREEN_GAME_OVER);
+      return;
     }
-    if(curtime > next_move) {
-      move_snake(snake);
-      if(detect_colision(snake)) {
-        game_over();
-        delay(2000);
-        creoqode.fillRect(1, 1, 60, 30, 0);
-        print_points();
-        while(true){
-          if(KEY_PRESSED(button_up) || KEY_PRESSED(button_down) ||
-             KEY_PRESSED(button_left) || KEY_PRESSED(button_right) ||
-             KEY_PRESSED(button_turbo) || KEY_PRESSED(button_pause)){
-            return;
-          }
-          delay(10);
-        }
-        break;
-      }
-      draw_snake(snake);
-      if(snake[0] == food){
-        snake[snake_len]=snake[snake_len-1];
-        snake_len++;
-        catches++;
-        points+=points_factor;
-        if((catches%LEVEL_UP_EVERY)==0 && game_speed > MAX_GAME_SPEED) {
-          points_factor++;
-          game_speed-=SPEEDUP;
-          creoqode.drawPixel(catches/10-1, 0, color_level_mark);
-        }
-        put_food(GET_POS(1,1), GET_POS(62,14), snake);
-      }
-      next_move = millis() + (turbo ? TURBO_SPEED : game_speed);
-      turbo = false;
+    tick_schedule((turbo ? TURBO_SPEED : game_speed) * 1000UL);
+    turbo = false;
+  }
+}
+
+void game_over_update() {
+  if (screen_step == 2) {
+    bool eligable = is_high_score_eligable(points, scores[game_mode]);
+    if (any_key_pressed()) {
+      enter_screen(eligable ? SCREEN_NAME_ENTRY : SCREEN_HIGH_SCORES);
+    } else if (!eligable && due(screen_deadline)) {
+      enter_screen(SCREEN_ATTRACT);
+    }
+    return;
+  }
+  if (!due(screen_deadline)) return;
+  switch (screen_step) {
+    case 0:
+      if (game_state == GAME_WON) game_won();
+      else game_over();
+      screen_wait(2000);
+      screen_step++;
+      break;
+    case 1:
+      panel_fill(1, 1, 60, 30, ink_black);
+      print_points();
+      input_flush();
+      screen_wait(ATTRACT_AFTER);
+      screen_step++;
+      break;
+  }
+}
+
+// A demo game steered by autoplay.h, searching between the ticks. Any key
+// starts a real game; the demo's score is not kept.
+void attract_update() {
+  if (screen_step == 0) {
+    screen_step = 1;
+    start_game(snake, analogRead(5)*millis());
+    autoplay_begin();
+    tick_start(0);
+    game_ticks = 0;
+  }
+  if (any_key_pressed()) {
+    enter_screen(SCREEN_PLAYING);
+    return;
+  }
+  if (screen_step == 2) {
+    if (due(screen_deadline)) enter_screen(SCREEN_HIGH_SCORES);
+    return;
+  }
+  if (!tick_due()) {
+    autoplay_step();
+    return;
+  }
+  snake_next_dir = autoplay_move();
+  game_state = game_tick(snake);
+  session_input(game_ticks, snake_direction, false, false);
+  session_tick(game_ticks, game_state);
+  game_ticks++;
+  if (game_state != GAME_RUNNING || game_ticks == ATTRACT_TICKS) {
+    session_timing();
+    autoplay_end();
+    screen_step = 2;
+    screen_wait(2000);
+    return;
+  }
+  autoplay_plan();
+  tick_schedule(game_speed * 1000UL);
+}
+
+void start_game(snake_cell snake[], unsigned long seed) {
+  store_wait();
+  randomSeed(seed);
+  session_begin(seed);
+  reset_snake(snake);
+  bitboard_fill(reach, board, snake_head_pos);
+  put_food(GET_POS(31, 15), GET_POS(33, 30));
+  redraw_snake(snake);
+}
+
+// One move of the snake. Everything that changes the game state happens
+// here, so a session replays from its seed and the directions alone.
+uint8_t game_tick(snake_cell snake[]) {
+  PROFILE_ZONE(PROF_TICK);
+  move_snake(snake);
+  if(detect_colision()) {
+    return GAME_CRASHED;
+  }
+  draw_snake();
+  unsigned int room = bitboard_fill(reach, board, snake_head_pos);
+  draw_trap_warning(room < snake_len && !tail_reachable());
+  if(snake_head_pos == food){
+    snake_grow++;
+    catches++;
+    points+=points_factor;
+    if((catches%LEVEL_UP_EVERY)==0 && game_speed > MAX_GAME_SPEED) {
+      points_factor++;
+      game_speed-=SPEEDUP;
+      panel_pixel(catches/10-1, 0, ink_level_mark);
+    }
+    if(!put_food(GET_POS(1,1), GET_POS(62,14))) {
+      return GAME_WON;
     }
   }
+  return GAME_RUNNING;
+}
+
+// Folds the state a tick leaves behind into a CRC-16.
+uint16_t game_checksum(uint16_t crc) {
+  const uint16_t state[] = {
+    (uint16_t)snake_head_pos, (uint16_t)snake_tail_pos, (uint16_t)snake_len,
+    (uint16_t)food, points, (uint16_t)snake_direction
+  };
+  return store_crc(crc, state, sizeof(state));
+}
+
+// board[] holds one bit per cell, set for the walls and every cell the
+// snake occupies, so collisions and free-cell tests are a single probe.
+// Its rows double as the walls of the flood fills in bitboard.h.
+void board_reset() {
+  memset(board, 0, sizeof(board));
+  for (unsigned int x = 0; x < 64; x++) {
+    board_set(GET_POS(x, 0));
+    board_set(GET_POS(x, 31));
+  }
+  for (unsigned int y = 1; y < 31; y++) {
+    board_set(GET_POS(0, y));
+    board_set(GET_POS(63, y));
+  }
+}
+
+bool board_test(unsigned int pos) {
+  return board[pos >> 3] & (1 << (pos & 7));
 }
 
-void reset_snake(unsigned int snake[]) {
+void board_set(unsigned int pos) {
+  board[pos >> 3] |= 1 << (pos & 7);
+}
+
+void board_clear(unsigned int pos) {
+  board[pos >> 3] &= ~(1 << (pos & 7));
+}
+
+// snake[] is a ring of SNAKE_MAX_LEN slots: the head sits at snake_head and
+// the body follows at decreasing slots, so a move only pushes a new head.
+// A slot holds the segment's position, or with SNAKE_PACKED_BODY the 2-bit
+// step from the segment towards the head. The end positions are kept in
+// snake_head_pos and snake_tail_pos either way.
+unsigned int snake_index(unsigned int segment) {
+  return snake_head >= segment ? snake_head - segment : snake_head + SNAKE_MAX_LEN - segment;
+}
+
+#if SNAKE_PACKED_BODY
+const int dir_steps[4] = { DIR_UP, DIR_RIGHT, DIR_DOWN, DIR_LEFT };
+
+uint8_t dir_code(int dir) {
+  return dir == DIR_UP ? 0 : (dir == DIR_RIGHT ? 1 : (dir == DIR_DOWN ? 2 : 3));
+}
+
+int snake_step(snake_cell snake[], unsigned int slot) {
+  return dir_steps[(snake[slot >> 2] >> ((slot & 3) << 1)) & 3];
+}
+#endif
+
+void snake_push_head(snake_cell snake[], int dir) {
+#if SNAKE_PACKED_BODY
+  uint8_t shift = (snake_head & 3) << 1;
+  snake[snake_head >> 2] = (snake[snake_head >> 2] & ~(3 << shift)) | (dir_code(dir) << shift);
+#endif
+  snake_head = snake_head == SNAKE_MAX_LEN-1 ? 0 : snake_head+1;
+  snake_head_pos += dir;
+#if !SNAKE_PACKED_BODY
+  snake[snake_head] = snake_head_pos;
+#endif
+}
+
+// Drops the segment behind the tail, right after snake_push_head().
+void snake_pop_tail(snake_cell snake[]) {
+#if SNAKE_PACKED_BODY
+  snake_tail_pos += snake_step(snake, snake_index(snake_len));
+#else
+  snake_tail_pos = snake[snake_index(snake_len-1)];
+#endif
+}
+
+// Position of the segment in front of the given one, which is at pos.
+unsigned int snake_towards_head(snake_cell snake[], unsigned int segment, unsigned int pos) {
+#if SNAKE_PACKED_BODY
+  return pos + snake_step(snake, snake_index(segment));
+#else
+  (void)pos;
+  return snake[snake_index(segment-1)];
+#endif
+}
+
+void reset_snake(snake_cell snake[]) {
   game_speed = INITIAL_GAME_SPEED;
-  snake_len = 2;
   points = 0;
   points_factor = 1;
   catches = 0;
   snake_direction = DIR_RIGHT;
   snake_next_dir = snake_direction;
-  memset(snake, 0, sizeof(*snake));
+  turn_count = 0;
   snake_old_tail = 0;
-  snake[0] = GET_POS(31,15);
-  snake[1] = GET_POS(32,15);
-  creoqode.drawRect(0, 0, 64, 32, color_border);
-  creoqode.fillRect(1, 1, 62, 30, 0);
+  snake_grow = 0;
+  snake_len = 1;
+  snake_head = 0;
+  snake_head_pos = GET_POS(32,15);
+  snake_tail_pos = snake_head_pos;
+#if !SNAKE_PACKED_BODY
+  snake[0] = snake_head_pos;
+#endif
+  snake_push_head(snake, DIR_LEFT);
+  snake_len = 2;
+  trap_flash = false;
+  board_reset();
+  board_set(snake_head_pos);
+  board_set(snake_tail_pos);
+  panel_rect(0, 0, 64, 32, ink_border);
+  panel_fill(1, 1, 62, 30, ink_black);
 }
 
-void draw_snake(unsigned int snake[]) {
-  if(snake_old_tail!=0) creoqode.drawPixel(GET_X(snake_old_tail), GET_Y(snake_old_tail), 0);
-  creoqode.drawPixel(GET_X(snake[0]), GET_Y(snake[0]), color_snake_head);
-  for(unsigned int i = 1; i < snake_len; i++){
-    creoqode.drawPixel(GET_X(snake[i]), GET_Y(snake[i]), (i%2==0 ? color_snake_even : color_snake_odd));
-  } 
+// Body stripes follow the ring slot a segment was spawned in, so a segment
+// keeps its colour for life and a move only touches three pixels.
+const panel_ink &segment_ink(unsigned int index) {
+  return index%2==0 ? ink_snake_even : ink_snake_odd;
 }
 
-void move_snake(unsigned int snake[]) {
-  snake_direction = snake_next_dir;
-  snake_old_tail = snake[snake_len-1];
-  for(int i = snake_len -1; i>0; i--){
-    snake[i] = snake[i-1];
+void redraw_snake(snake_cell snake[]) {
+  unsigned int pos = snake_tail_pos;
+  for(unsigned int i = snake_len-1; i > 0; i--){
+    panel_pixel(GET_X(pos), GET_Y(pos), segment_ink(snake_index(i)));
+    pos = snake_towards_head(snake, i, pos);
   }
-  snake[0] = snake[0] + snake_direction;
+  panel_pixel(GET_X(snake_head_pos), GET_Y(snake_head_pos), ink_snake_head);
 }
 
-bool detect_colision(unsigned int snake[]) {
-  if(GET_X(snake[0]) == 0 || GET_X(snake[0]) == 63) {
-    return true;
+void draw_snake() {
+  PROFILE_ZONE(PROF_DRAW);
+  if(snake_old_tail!=0) panel_pixel(GET_X(snake_old_tail), GET_Y(snake_old_tail), ink_black);
+  unsigned int neck = snake_head_pos - snake_direction;
+  panel_pixel(GET_X(neck), GET_Y(neck), segment_ink(snake_index(1)));
+  panel_pixel(GET_X(snake_head_pos), GET_Y(snake_head_pos), ink_snake_head);
+}
+
+// Whether the head's room (reach[]) touches the tail, which moves away and
+// opens a way out.
+bool tail_reachable() {
+  const int dirs[4] = { DIR_UP, DIR_RIGHT, DIR_DOWN, DIR_LEFT };
+  for (uint8_t i = 0; i < 4; i++) {
+    unsigned int pos = snake_tail_pos + dirs[i];
+    if (pos == snake_head_pos || bitboard_test(reach, pos)) return true;
   }
-  if(GET_Y(snake[0])== 0 || GET_Y(snake[0])== 31) {
-    return true;
+  return false;
+}
+
+// Flashes the border, all but the top row with the level marks, every
+// other tick while the head is shut in with less room than the snake is
+// long and no way to its tail.
+void draw_trap_warning(bool trapped) {
+  if (!trapped && !trap_flash) return;
+  trap_flash = trapped && !trap_flash;
+  const panel_ink &ink = trap_flash ? ink_trapped : ink_border;
+  panel_vspan(0, 1, 31, ink);
+  panel_vspan(63, 1, 31, ink);
+  panel_span(1, 31, 62, ink);
+}
+
+// Turns are checked against the last queued direction, so "up then left"
+// pressed within one tick lands on two consecutive moves.
+bool queue_turn(int dir) {
+  int last = turn_count > 0 ? turn_queue[(turn_first + turn_count - 1) % TURN_QUEUE_LEN] : snake_direction;
+  if (dir == last || dir == -last || turn_count == TURN_QUEUE_LEN) {
+    return false;
   }
-  for(unsigned int i=1; i<snake_len; i++){
-    if(snake[0] == snake[i]){
-      return true;
-    }
+  turn_queue[(turn_first + turn_count) % TURN_QUEUE_LEN] = dir;
+  turn_count++;
+  return true;
+}
+
+void move_snake(snake_cell snake[]) {
+  PROFILE_ZONE(PROF_MOVE);
+  if (turn_count > 0) {
+    snake_next_dir = turn_queue[turn_first];
+    turn_first = (turn_first + 1) % TURN_QUEUE_LEN;
+    turn_count--;
+  }
+  snake_direction = snake_next_dir;
+  snake_push_head(snake, snake_direction);
+  // After a catch the tail stays put for one move.
+  if (snake_grow > 0) {
+    snake_grow--;
+    snake_len++;
+    snake_old_tail = 0;
+  } else {
+    snake_old_tail = snake_tail_pos;
+    snake_pop_tail(snake);
+    board_clear(snake_old_tail);
   }
+}
 
+// Walls are pre-set on the board, so one probe covers them and the body.
+// The head claims its cell afterwards.
+bool detect_colision() {
+  PROFILE_ZONE(PROF_COLLIDE);
+  if(board_test(snake_head_pos)) {
+    return true;
+  }
+  board_set(snake_head_pos);
   return false;
 }
 
 void game_over(){
+  PROFILE_ZONE(PROF_TEXT);
   creoqode.setTextSize(2);
   creoqode.setCursor(8, 1);
   creoqode.setTextColor(color_gameover);
   creoqode.setTextWrap(true);
-  creoqode.print("GAME OVER");
+  creoqode.print(F("GAME OVER"));
+}
+
+void game_won(){
+  PROFILE_ZONE(PROF_TEXT);
+  creoqode.setTextSize(2);
+  creoqode.setTextColor(color_title);
+  creoqode.setCursor(14, 1);
+  creoqode.print(F("YOU"));
+  creoqode.setCursor(14, 17);
+  creoqode.print(F("WIN"));
 }
 
 void print_points(){
-  creoqode.setTextSize(1);
-  creoqode.setCursor(2, 2);
-  creoqode.setTextColor(color_score_title);
-  creoqode.print("You've got");
-  String points_string = String(points);
-  uint16_t text_width = 0;
-  creoqode.getTextBounds((char*)points_string.c_str(), 0, 0, NULL, NULL, &text_width, NULL);
-  creoqode.setCursor(32-(text_width/2), 12);
-  creoqode.setTextColor(color_score_points);
-  creoqode.print(String(points_string));
-  creoqode.setTextColor(color_score_title);
-  creoqode.setCursor(points==1?18:14, 22);
-  creoqode.print(points==1?"point":"points");
-
-}
-
-void put_food(int first, int last, unsigned int snake[]){
-  unsigned int new_food;
-  while(true){
-    new_food = random(first, last+1);
-    bool colision = false;
-    for(unsigned int i = 0; i < snake_len; i++){
-      if(new_food == snake[i]) {
-        colision = true;
-        break;
-      }
+  PROFILE_ZONE(PROF_TEXT);
+  text_draw_P(FONT_5X7, 2, 9, PSTR("You've got"), color_score_title);
+  text_draw_number(FONT_5X7, 32-(text_number_width(FONT_5X7, points)/2), 19, points, color_score_points);
+  if (points == 1) {
+    text_draw_P(FONT_5X7, 32-(TEXT_WIDTH(FONT_5X7, "point")/2), 29, PSTR("point"), color_score_title);
+  } else {
+    text_draw_P(FONT_5X7, 32-(TEXT_WIDTH(FONT_5X7, "points")/2), 29, PSTR("points"), color_score_title);
+  }
+  // The rank goes left of the score, which starts at x 17 even with the
+  // five digits of SCORE_MAX, so a two-digit rank fits in front of it.
+  if (is_high_score_eligable(points, scores[game_mode])) {
+    creoqode.setFont(&Picopixel);
+    creoqode.setTextSize(1);
+    creoqode.setCursor(2, 18);
+    creoqode.print('#');
+    creoqode.print(high_score_rank(points, scores[game_mode]) + 1);
+    creoqode.setFont();
+  }
+}
+
+// Where the score so far would rank ("#N"), dim in the bottom right corner
+// of the field, where food never lands. It is drawn after every tick and
+// skips the cells the snake takes, so it never hides the snake and cells
+// the tail leaves get it back at once. Off the table, nothing is shown.
+static unsigned int live_rank_shown = NUM_HI_SCORES;
+static uint8_t live_rank_width = 0;
+
+static uint8_t draw_rank_glyph(uint8_t x, char c) {
+  for (uint8_t row = 0; row < 5; row++) {
+    uint8_t y = LIVE_RANK_BASELINE - 4 + row;
+    uint8_t bits = text_glyph_row(FONT_5X5, c, row);
+    for (uint8_t i = 0; bits != 0; i++, bits <<= 1) {
+      if ((bits & 0x80) && !board_test(GET_POS(x + i, y))) panel_pixel(x + i, y, ink_live_rank);
     }
-    if(colision == true) continue;
-    if(GET_X(new_food) == 0 || GET_X(new_food) == 63) continue;
-    if(GET_Y(new_food) == 0 || GET_Y(new_food) == 31) continue;
-    break;
   }
-  food = new_food;
-  creoqode.drawPixel(GET_X(food), GET_Y(food), color_food);
+  return c == '#' ? TEXT_WIDTH(FONT_5X5, "#") : text_number_width(FONT_5X5, c - '0');
 }
 
-void draw_logo() {
-  #define LOGO_WIDTH 60
-  const bool code[] = {
-    true,true,false,false,true,true,false,true,false,false,true,true,true,false,false,true,
-    false,false,true,false,true,true,false,false,true,true,false,true,false,false,true,false,
-    false,true,true,false,true,false,false,true,true,false,true,false,false,true,true,false,
-    true,false,false,true,true,true,false,false,true,false,false,true
-  };
-  const unsigned int code_and_text[] = {
-    2,11,16,31,52,71,91,112,122,125,128,131,136,139,140,141,142,145,146,147,148,151,154,155,
-    156,157,160,161,162,163,166,169,172,177,178,179,180,182,185,188,191,196,202,205,208,214,
-    222,226,229,232,237,242,245,248,251,256,259,260,261,262,265,268,274,275,276,277,281,286,
-    289,292,297,302,305,308,311,316,319,322,325,328,337,340,346,349,352,357,362,365,366,367,
-    368,371,372,373,376,379,380,381,382,385,388,391,394,395,396,397,400,401,402,403,406,407,
-    408,409,412,413,414,417,418,419,420,421,422
-  };
-  for(unsigned int i = 0; i < sizeof(code); i++){
-    if(code[i]==true) {
-      for(int j=1; j < 20; j++){
-        creoqode.drawPixel(i+2, j, color_logo);
+void draw_live_rank() {
+  unsigned int rank = points == 0 ? NUM_HI_SCORES : high_score_rank(points, scores[game_mode]);
+  if (rank != live_rank_shown) {
+    for (uint8_t y = LIVE_RANK_BASELINE - 4; y <= LIVE_RANK_BASELINE; y++) {
+      for (uint8_t x = LIVE_RANK_RIGHT + 1 - live_rank_width; x <= LIVE_RANK_RIGHT; x++) {
+        if (!board_test(GET_POS(x, y))) panel_pixel(x, y, ink_black);
       }
     }
+    live_rank_shown = rank;
+    live_rank_width = 0;
+    if (rank < NUM_HI_SCORES) live_rank_width = TEXT_WIDTH(FONT_5X5, "#") + text_number_width(FONT_5X5, rank + 1);
   }
-  for(int j=20; j < 23; j++){
-    creoqode.drawPixel(30+2, j, color_logo);
+  if (live_rank_width == 0) return;
+  uint8_t x = LIVE_RANK_RIGHT + 1 - live_rank_width;
+  x += draw_rank_glyph(x, '#');
+  if (rank + 1 >= 10) x += draw_rank_glyph(x, '0' + (rank + 1) / 10);
+  draw_rank_glyph(x, '0' + (rank + 1) % 10);
+}
+
+// Picks uniformly among the cells of the range the head can reach (reach[],
+// filled this tick), or of the whole board once there are none in the
+// range. Food never lands in a pocket the body has closed off, unless the
+// head itself is walled in. Returns false when no cell is left.
+bool put_food(int first, int last){
+  PROFILE_ZONE(PROF_FOOD);
+  unsigned int cells = bitboard_count(reach, first, last);
+  if(cells == 0) {
+    first = GET_POS(1,1);
+    last = GET_POS(62,30);
+    cells = bitboard_count(reach, first, last);
   }
-  for(int i = 0; i < 123; i++){
-    creoqode.drawPixel(((code_and_text[i]-1)%LOGO_WIDTH)+2, ((code_and_text[i]-1)/LOGO_WIDTH)+23, color_logo);
+  if(cells == 0) {
+    bitboard_free(reach, board);
+    cells = bitboard_count(reach, first, last);
+    if(cells == 0) return false;
   }
+  food = bitboard_nth(reach, first, last, random(cells));
+  panel_pixel(GET_X(food), GET_Y(food), ink_food);
+  return true;
 }
 
-String enter_name() {
-  unsigned long entry_time = millis();
-  const long action_delay = 500;
-  const int x = 8;
-  const int y = 6;
-  const int buff_width = 1;
-  const int char_height = 6;
-  const int before_lines = 6;
-  const int after_lines = 7;
-  const int max_letters = NAME_LEN;
-  int letter_indexes[max_letters];
-  int current_letter = 0;
-  bool allow_commit = true;
-  unsigned char name[max_letters+1];
-  const char letters[] = {
-    'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
-    'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
-    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
-    ' ', '_', '.', '@', '!', '?', ':'
-  };
-  memset((int*) letter_indexes, -1, sizeof(letter_indexes));
-  memset((unsigned char*) name, '\0', sizeof(name));
-  unsigned int canvas_h = char_height*sizeof(letters);
-  GFXcanvas1 canvas(8, canvas_h);
-  canvas.setFont(&Font5x5Fixed);
-  unsigned int additional_color = creoqode.Color444(0, 2, 0);
-  unsigned int main_color = creoqode.Color444(4, 0, 2);
-  unsigned int bg_color = creoqode.Color444(0, 0, 0);
-  for (unsigned int i = 0; i < sizeof(letters); i++) {
-    canvas.drawChar(1, 6*(i+1)-1, letters[i], additional_color, 0, 1);
-  }
-
-  uint8_t before_buffs[before_lines][buff_width];
-  uint8_t after_buffs[after_lines][buff_width];
-  uint8_t buff[buff_width * char_height];
-  uint8_t* snap = canvas.getBuffer();
-
-  bool left_btn_up = true;
-  bool right_btn_up = true;
-
-  int i = 0;
-  int selected_index = 0;
-  int letters_dir = 1;
-  name[0] = letters[selected_index];
-  letter_indexes[0] = selected_index;
-  if (KEY_PRESSED(button_turbo)) allow_commit = false;
-  creoqode.drawRect(x-1, y-1, max_letters*buff_width*8+2, before_lines+char_height+after_lines+2, creoqode.Color444(2, 2, 0));
-  creoqode.fillRect(x,y,max_letters*buff_width*8, before_lines+char_height+after_lines, bg_color);
-  while(true) {
-    while (true) {
-      for (unsigned int j = 0; j < sizeof(buff); j++ ) {
-        buff[j] = snap[(i*buff_width+j)%(buff_width*canvas_h)];
-      }
-      for (int b = before_lines; b > 0; b--) {
-        int index = i - b;
-        if (index < 0) {
-        index = index + canvas_h;
-        }
-        for (unsigned int j = 0; j < sizeof(before_buffs[b]); j++ ) {
-          before_buffs[before_lines - b][j] = snap[(index*buff_width+j)%(buff_width*canvas_h)];
-        }
-      }
+void draw_logo() {
+  asset_draw(asset_logo, 2, 1, color_logo);
+}
 
-      for (int a = 0; a < after_lines; a++) {
-        unsigned int index = i + char_height + a;
-        if (index >= canvas_h) {
-          index = index - canvas_h;
-        }
-        for (unsigned int j = 0; j < sizeof(after_buffs[a]); j++ ) {
-          after_buffs[a][j] = snap[index*buff_width+j];
-        }
-      }
+// The wheel keeps its state in `entry` between loop() passes.
+void name_entry_begin() {
+  memset((int*) entry.letter_indexes, -1, sizeof(entry.letter_indexes));
+  memset((unsigned char*) entry.name, '\0', sizeof(entry.name));
+  entry.entry_time = curtime;
+  entry.current_letter = 0;
+  entry.selected_index = 0;
+  entry.i = 0;
+  entry.letters_dir = 1;
+  entry.scrolling = true;
 
-      for (int i = 0; i < before_lines; i++) {
-        creoqode.drawBitmap(x + (current_letter*8), y+i, before_buffs[i], 8, 1, additional_color, bg_color);
-      }
-      creoqode.drawBitmap(x + (current_letter*8), y+before_lines, buff, 8, char_height, main_color, bg_color);
-      for(int i = 0; i < after_lines; i++) {
-        creoqode.drawBitmap(x + (current_letter*8), y+i + before_lines + char_height, after_buffs[i], 8, 1, additional_color, bg_color);
-      }
-      if (i == selected_index * char_height) {
-        break;
-      }
-      i = i + letters_dir;
-      if (i < 0) {
-        i = canvas_h -1;
-      }
-      i = (i % canvas_h);
-      delay(20);
-    }
-    while(true) {
-      if (millis() - entry_time < action_delay) continue;
-      if(!allow_commit && KEY_NOT_PRESSED(button_turbo)) {
-        allow_commit = true;
-        delay(100);
-      }
-      if(!left_btn_up && KEY_NOT_PRESSED(button_left)) {
-        left_btn_up = true;
-        delay(15);
-      }
-      if(!right_btn_up && KEY_NOT_PRESSED(button_right)) {
-        right_btn_up = true;
-        delay(15);
-      }
-      if (KEY_PRESSED(button_up)) {
-        selected_index -= 1;
-        if (selected_index < 0) selected_index = sizeof(letters) - 1;
-        letters_dir = -1;
-        letter_indexes[current_letter] = selected_index;
-        name[current_letter] = letters[selected_index];
-        break;
-      } else if (KEY_PRESSED(button_down)) {
-        selected_index = (selected_index + 1) % sizeof(letters);
-        letters_dir = 1;
-        letter_indexes[current_letter] = selected_index;
-        name[current_letter] = letters[selected_index];
-        break;
-      } else if (right_btn_up && KEY_PRESSED(button_right)) {
-        if (current_letter < max_letters-1) {
-          right_btn_up = false;
-          letter_indexes[current_letter] = selected_index;
-          name[current_letter] = letters[selected_index];
-          creoqode.fillRect(x+(current_letter*buff_width*8),y,buff_width*8, before_lines, bg_color);
-          creoqode.fillRect(x+(current_letter*buff_width*8),y+before_lines+char_height,buff_width*8, after_lines, bg_color);
-          current_letter += 1;
-          selected_index = 0;
-          letter_indexes[current_letter] = selected_index;
-          name[current_letter] = letters[selected_index];
-          i = 0;
-          break;
-        }
-      } else if (left_btn_up && KEY_PRESSED(button_left)) {
-        if (current_letter > 0) {
-          left_btn_up = false;
-          selected_index = letter_indexes[current_letter-1];
-          i = selected_index * char_height;
-          creoqode.fillRect(x+(current_letter*buff_width*8),y,buff_width*8, before_lines+char_height+after_lines, bg_color);
-          letter_indexes[current_letter] = -1;
-          name[current_letter] = '\0';
-          current_letter -= 1;
-          break;
-        }
-      } else if (allow_commit && KEY_PRESSED(button_turbo)) {
-        creoqode.fillRect(x,y,(current_letter+1)*buff_width*8, before_lines+char_height+after_lines, bg_color);
-        return String((const char*)name);
-      }
-    }
+  entry.name[0] = pgm_read_byte(&name_letters[entry.selected_index]);
+  entry.letter_indexes[0] = entry.selected_index;
+  panel_rect(wheel_x-1, wheel_y-1, NAME_LEN*wheel_buff_width*8+2, wheel_before_lines+wheel_char_height+wheel_after_lines+2, panel_ink_for(panel_color(2, 2, 0)));
+  panel_fill(wheel_x,wheel_y,NAME_LEN*wheel_buff_width*8, wheel_before_lines+wheel_char_height+wheel_after_lines, wheel_bg_ink);
+}
+
+// Row of the wheel strip, the letters stacked one per wheel_char_height
+// rows with their baseline on the last one. Rows come straight from the
+// glyph atlas; a descender spills into the first row of the next letter.
+uint8_t wheel_row(int index) {
+  int slot = index / wheel_char_height;
+  int8_t row = index % wheel_char_height - wheel_glyph_top;
+  uint8_t bits = text_glyph_row(FONT_5X5, pgm_read_byte(&name_letters[slot]), row);
+  if (slot > 0) {
+    bits |= text_glyph_row(FONT_5X5, pgm_read_byte(&name_letters[slot-1]), row + wheel_char_height);
   }
-  return "ERROR";  
+  return bits >> 1;
 }
 
-int compare_points(const void * a, const void *b) {
-  uint16_t pa = ((highscore_entry *) a)->points;
-  uint16_t pb = ((highscore_entry *) b)->points;
-  return pa > pb ? -1 : (pa < pb ? 1 : 0);
+void draw_name_wheel() {
+  const int x = wheel_x + entry.current_letter*wheel_buff_width*8;
+  const int char_height = wheel_char_height;
+  const int before_lines = wheel_before_lines;
+  const int after_lines = wheel_after_lines;
+  const int canvas_h = char_height*NAME_LETTERS;
+
+  for (int line = 0; line < before_lines+char_height+after_lines; line++) {
+    int index = entry.i - before_lines + line;
+    if (index < 0) {
+      index = index + canvas_h;
+    } else if (index >= canvas_h) {
+      index = index - canvas_h;
+    }
+    bool selected = line >= before_lines && line < before_lines+char_height;
+    panel_row_opaque(x, wheel_y+line, wheel_row(index), selected ? wheel_main_ink : wheel_additional_ink, wheel_bg_ink);
+  }
 }
 
-void show_high_scores(highscores &scores_table) {
-  const unsigned int score_line_height = 7;
+void name_entry_update() {
+  const int x = wheel_x;
+  const int y = wheel_y;
+  const int buff_width = wheel_buff_width;
+  const int char_height = wheel_char_height;
+  const int before_lines = wheel_before_lines;
+  const int after_lines = wheel_after_lines;
+  const int max_letters = NAME_LEN;
+  const int canvas_h = char_height*NAME_LETTERS;
 
-  highscore_entry entries[NUM_HI_SCORES];
-  unsigned int found_scores = 0;
+  if (screen_step == 0) {
+    name_entry_begin();
+    screen_step = 1;
+  }
+  if (!due(screen_deadline)) return;
+  if (entry.scrolling) {
+    draw_name_wheel();
+    if (entry.i == entry.selected_index * char_height) {
+      entry.scrolling = false;
+      return;
+    }
+    entry.i = entry.i + entry.letters_dir;
+    if (entry.i < 0) {
+      entry.i = canvas_h -1;
+    }
+    entry.i = (entry.i % canvas_h);
+    screen_wait(20);
+    return;
+  }
 
-  for (int i = 0; i < NUM_HI_SCORES; i++) {
-    if (scores_table.scores[i].name[0] != '\0') {
-      entries[found_scores] = scores_table.scores[i];
-      found_scores += 1;
+  if (curtime - entry.entry_time < name_action_delay) {
+    input_flush();
+    return;
+  }
+  // Queued presses first, then up/down keep stepping while held.
+  uint8_t action = 0;
+  input_event event;
+  while (action == 0 && input_next(event)) {
+    if (event.pressed) action = event.button;
+  }
+  if (action == 0) action = input_held() & (BTN_UP | BTN_DOWN);
+  int current_letter = entry.current_letter;
+  if (action & BTN_UP) {
+    entry.selected_index -= 1;
+    if (entry.selected_index < 0) entry.selected_index = NAME_LETTERS - 1;
+    entry.letters_dir = -1;
+    entry.letter_indexes[current_letter] = entry.selected_index;
+    entry.name[current_letter] = pgm_read_byte(&name_letters[entry.selected_index]);
+    entry.scrolling = true;
+  } else if (action & BTN_DOWN) {
+    entry.selected_index = (entry.selected_index + 1) % NAME_LETTERS;
+    entry.letters_dir = 1;
+    entry.letter_indexes[current_letter] = entry.selected_index;
+    entry.name[current_letter] = pgm_read_byte(&name_letters[entry.selected_index]);
+    entry.scrolling = true;
+  } else if (action & BTN_RIGHT) {
+    if (current_letter < max_letters-1) {
+      entry.letter_indexes[current_letter] = entry.selected_index;
+      entry.name[current_letter] = pgm_read_byte(&name_letters[entry.selected_index]);
+      panel_fill(x+(current_letter*buff_width*8),y,buff_width*8, before_lines, wheel_bg_ink);
+      panel_fill(x+(current_letter*buff_width*8),y+before_lines+char_height,buff_width*8, after_lines, wheel_bg_ink);
+      current_letter += 1;
+      entry.current_letter = current_letter;
+      entry.selected_index = 0;
+      entry.letter_indexes[current_letter] = entry.selected_index;
+      entry.name[current_letter] = pgm_read_byte(&name_letters[entry.selected_index]);
+      entry.i = 0;
+      entry.scrolling = true;
+    }
+  } else if (action & BTN_LEFT) {
+    if (current_letter > 0) {
+      entry.selected_index = entry.letter_indexes[current_letter-1];
+      entry.i = entry.selected_index * char_height;
+      panel_fill(x+(current_letter*buff_width*8),y,buff_width*8, before_lines+char_height+after_lines, wheel_bg_ink);
+      entry.letter_indexes[current_letter] = -1;
+      entry.name[current_letter] = '\0';
+      entry.current_letter = current_letter - 1;
+      entry.scrolling = true;
     }
+  } else if (action & BTN_TURBO) {
+    panel_fill(x,y,(current_letter+1)*buff_width*8, before_lines+char_height+after_lines, wheel_bg_ink);
+    register_high_score((const char*)entry.name, points, scores[game_mode]);
+    save_high_scores(scores);
+    enter_screen(SCREEN_HIGH_SCORES);
   }
-  creoqode.fillRect(0, 0, 64, 32, 0);
-  if (found_scores == 0) {
+}
+
+void high_scores_begin(highscores &scores_table) {
+  view.found_scores = high_score_rank(1, scores_table);
+  view.offset = 0;
+  view.scroll_time = 0;
+  view.idle_time = curtime;
+  creoqode.fillScreen(0);
+  if (view.found_scores == 0) {
     creoqode.setFont(&Picopixel);
-    creoqode.setTextColor(creoqode.Color444(1,3,2));
+    creoqode.setTextColor(panel_color(1, 3, 2));
     creoqode.setTextSize(1);
     creoqode.setCursor(5, 8);
-    creoqode.println("No High Scores\n\nPlay some games");
-    while ((true)) {
-      if (KEY_PRESSED(button_turbo) || KEY_PRESSED(button_pause)) {
-          break;
-      }
-    }
-    
+    creoqode.println(F("No High Scores\n\nPlay some games"));
   } else {
-    qsort(entries, NUM_HI_SCORES, sizeof(entries[0]), compare_points);
-    unsigned int offset = 0;
-    bool do_score_loop = true;
-    unsigned long latch_durarion = 750;
-    unsigned long up_latch = 0;
-    unsigned long down_latch = 0;
-    uint16_t pos_color = creoqode.Color444(2, 2, 0);
-    uint16_t name_color = creoqode.Color444(0, 2, 0);
-    uint16_t points_color = creoqode.Color444(2, 0, 2);
-    while (do_score_loop) {
-      unsigned int page_index = 0;
-      creoqode.fillRect(0, 0, 64, 32, 0);
-      for (unsigned int i = offset; i < found_scores; i++) {
-        unsigned int base_line = page_index*score_line_height;
-        char name_buff[NAME_LEN+1];
-        memset(name_buff, '\0', sizeof(name_buff));
-        memcpy(name_buff, entries[i].name, NAME_LEN);
-        creoqode.setTextSize(1);
-        creoqode.setTextWrap(false);
-        // place
-        unsigned int place = i+1;
-        creoqode.setFont(&Font2x5FixedMonoNum);
-        creoqode.setTextColor(pos_color);
-        creoqode.setCursor(place < 10 ? 3 : 0, 6+base_line);
-        creoqode.print(i+1);
-
-        // name
-        creoqode.setFont(&Font5x5Fixed);
-        creoqode.setTextColor(name_color);
-        creoqode.setCursor(7,5+base_line);
-        creoqode.print((const char*) name_buff);
-
-        // points
-        unsigned int row_points = entries[i].points;
-        unsigned int points_margin = 0;
-        if (row_points < 10) {
-          points_margin = 4*4;
-        } else if (row_points < 100) {
-          points_margin = 3*4;
-        } else if (row_points < 1000) {
-          points_margin = 2*4;
-        } else if (row_points < 10000) {
-          points_margin = 4;
-        }
-        creoqode.setFont(&Font3x5FixedNum);
-        creoqode.setCursor(45 + points_margin,6+base_line);
-        creoqode.setTextColor(points_color);
-        creoqode.print(row_points); 
-        page_index += 1;
-        if (page_index > 4) {
-          break;
-        }
-      }
-      while (true) {
-        if (down_latch > 0 && KEY_NOT_PRESSED(button_down)) {
-          down_latch = 0;
-          delay(20);
-        }
-        if (up_latch > 0 && KEY_NOT_PRESSED(button_up)) {
-          up_latch = 0;
-          delay(20);
-        }
-        if ((found_scores > 4 && offset < found_scores - 4) && KEY_PRESSED(button_down)) {
-          if (down_latch == 0 || (millis() - down_latch) > latch_durarion) {
-            down_latch = millis();  
-            offset += 1;
-            break;
-          }
-        }
-        if ((offset > 0) && KEY_PRESSED(button_up)) {
-          if (up_latch == 0 || (millis() - up_latch) > latch_durarion) {
-            up_latch = millis();
-            offset -= 1;
-            break;
-          }
-        }
-        if (KEY_PRESSED(button_turbo) || KEY_PRESSED(button_pause)) {
-          do_score_loop = false;
-          break;
-        }
-      }
-    }
+    draw_high_scores_page();
   }
-  creoqode.setFont();
 }
 
-void register_high_score(String name, uint16_t points, highscores &highscores_table) {
-  highscore_entry* lowest_entry = nullptr;
-  for (unsigned int i = 0; i < NUM_HI_SCORES; i++) {
-    uint16_t current_points = highscores_table.scores[i].points;
-    if (current_points == 0) {
-      lowest_entry = &highscores_table.scores[i];
+void draw_high_scores_page() {
+  const unsigned int score_line_height = 7;
+  uint16_t pos_color = panel_color(2, 2, 0);
+  uint16_t name_color = panel_color(0, 2, 0);
+  uint16_t points_color = panel_color(2, 0, 2);
+  unsigned int page_index = 0;
+  creoqode.fillScreen(0);
+  for (unsigned int i = view.offset; i < view.found_scores; i++) {
+    unsigned int base_line = page_index*score_line_height;
+    char name_buff[NAME_LEN+1];
+    memset(name_buff, '\0', sizeof(name_buff));
+    memcpy(name_buff, scores[game_mode].scores[i].name, NAME_LEN);
+    // place, right aligned
+    unsigned int place = i+1;
+    text_draw_number(FONT_2X5_NUM, 6 - text_number_width(FONT_2X5_NUM, place), 6+base_line, place, pos_color);
+
+    // name
+    text_draw(FONT_5X5, 7, 5+base_line, name_buff, name_color);
+
+    // points, right aligned
+    unsigned int row_points = scores[game_mode].scores[i].points;
+    text_draw_number(FONT_3X5_NUM, 65 - text_number_width(FONT_3X5_NUM, row_points), 6+base_line, row_points, points_color);
+    page_index += 1;
+    if (page_index > 4) {
       break;
     }
-    if (current_points < points && (lowest_entry == NULL || lowest_entry->points >= current_points)) {
-      lowest_entry = &highscores_table.scores[i];
+  }
+}
+
+void high_scores_update() {
+  const unsigned long latch_durarion = 750;
+  if (screen_step == 0) {
+    high_scores_begin(scores[game_mode]);
+    screen_step = 1;
+  }
+  if (!due(screen_deadline)) return;
+  if (screen_step == 2) {
+    enter_screen(SCREEN_PLAYING);
+    return;
+  }
+  uint8_t scroll = 0;
+  input_event event;
+  while (input_next(event)) {
+    if (!event.pressed) continue;
+    if (event.button & (BTN_TURBO | BTN_PAUSE)) {
+      creoqode.setFont();
+      screen_step = 2;
+      screen_wait(125);
+      return;
     }
+    scroll |= event.button;
+  }
+  if (scroll || input_held()) view.idle_time = curtime;
+  if (due(view.idle_time + ATTRACT_AFTER)) {
+    creoqode.setFont();
+    enter_screen(SCREEN_ATTRACT);
+    return;
   }
-  if (lowest_entry != nullptr) {
-    memcpy(lowest_entry->name, name.c_str(), NAME_LEN);
-    lowest_entry->points = points;
+  if (view.found_scores == 0) return;
+  if (curtime - view.scroll_time > latch_durarion) scroll |= input_held();
+  if ((view.found_scores > 4 && view.offset < view.found_scores - 4) && (scroll & BTN_DOWN)) {
+    view.scroll_time = curtime;
+    view.offset += 1;
+    draw_high_scores_page();
+  } else if ((view.offset > 0) && (scroll & BTN_UP)) {
+    view.scroll_time = curtime;
+    view.offset -= 1;
+    draw_high_scores_page();
   }
 }
 
-bool is_high_score_eligable(uint16_t current_points, highscores &highscores_table) {
-  if (current_points == 0) {
-    return false;
+// The table is kept sorted, best first, with the empty entries (0 points)
+// trailing. A new score goes below the ones it ties with.
+void register_high_score(const char *name, uint16_t points, highscores &highscores_table) {
+  unsigned int rank = high_score_rank(points, highscores_table);
+  if (rank >= NUM_HI_SCORES) return;
+  highscore_entry* entries = highscores_table.scores;
+  memmove(&entries[rank+1], &entries[rank], (NUM_HI_SCORES-1-rank)*sizeof(highscore_entry));
+  memset(entries[rank].name, '\0', NAME_LEN);
+  size_t len = strlen(name);
+  memcpy(entries[rank].name, name, len < NAME_LEN ? len : NAME_LEN);
+  entries[rank].points = points;
+}
+
+// Number of entries scoring at least `points`, found by binary search.
+unsigned int high_score_rank(uint16_t points, highscores &highscores_table) {
+  unsigned int low = 0;
+  unsigned int high = NUM_HI_SCORES;
+  while (low < high) {
+    unsigned int mid = (low + high) / 2;
+    if (highscores_table.scores[mid].points >= points) low = mid + 1;
+    else high = mid;
   }
-  for (unsigned int i = 0; i < NUM_HI_SCORES; i++) {
-      if (current_points > highscores_table.scores[i].points) return true;
+  return low;
+}
+
+// Finds the newest saved boards. Older layouts and blank or foreign
+// EEPROMs are converted to a fresh log holding whatever could be read;
+// tables from before v4 become the classic board.
+void mount_high_scores(highscores boards[]) {
+  bool ours = EEPROM.read(0) == eeprom_magic[0] && EEPROM.read(1) == eeprom_magic[1];
+  uint8_t version = EEPROM.read(2);
+  highscores &highscores_table = boards[MODE_CLASSIC];
+  legacy_highscores legacy;
+  bool legacy_read = false;
+  if (ours && version == eeprom_version) {
+    uint8_t *packed = (uint8_t *)reach;
+    if (log_mount() && log_read(packed, LOG_PAYLOAD_LEN) && scores_unpack(packed, LOG_PAYLOAD_LEN, boards, NUM_MODES)) {
+      return;
+    }
+  } else if (ours && version == 0x01) {
+    EEPROM.get(HIGH_SCORES_V1_ADDRESS, legacy);
+    legacy_read = true;
+  } else if (ours && version == 0x02) {
+    legacy_read = load_v2_high_scores(legacy);
+  } else if (ours && version == 0x03) {
+    legacy_read = log_read_legacy(HIGH_SCORES_V3_SLOT_LEN, &legacy, sizeof(legacy));
   }
-  return false;
+  if (legacy_read) import_legacy_scores(legacy, highscores_table);
+  // The version goes first: a conversion cut short then leaves an empty
+  // log rather than an old table read with the wrong layout.
+  EEPROM.update(0, eeprom_magic[0]);
+  EEPROM.update(1, eeprom_magic[1]);
+  EEPROM.update(2, eeprom_version);
+  log_format();
+  save_high_scores(boards);
+}
+
+bool load_v2_high_scores(legacy_highscores &legacy) {
+  uint16_t crc;
+  EEPROM.get(HIGH_SCORES_V2_CRC_ADDRESS, crc);
+  EEPROM.get(HIGH_SCORES_V2_ADDRESS, legacy);
+  return crc == store_crc(0, &legacy, sizeof(legacy));
+}
+
+// Ranks the entries of an old table, in whatever order they were saved,
+// into the board. Points above SCORE_MAX cannot be packed and only come
+// from erased or foreign cells, so those entries are dropped with the
+// empty ones.
+void import_legacy_scores(const legacy_highscores &legacy, highscores &highscores_table) {
+  highscore_entry* entries = highscores_table.scores;
+  for (unsigned int i = 0; i < LEGACY_HI_SCORES; i++) {
+    const highscore_entry &entry = legacy.scores[i];
+    if (entry.name[0] == '\0' || entry.points == 0 || entry.points > SCORE_MAX) continue;
+    unsigned int rank = high_score_rank(entry.points, highscores_table);
+    if (rank >= NUM_HI_SCORES) continue;
+    memmove(&entries[rank+1], &entries[rank], (NUM_HI_SCORES-1-rank)*sizeof(highscore_entry));
+    entries[rank] = entry;
+  }
+}
+
+// Queued in the background; only the bytes that changed are programmed.
+// The record is built in reach[], which only games and demos use, and
+// written from there in the background; start_game() waits for it.
+void save_high_scores(highscores boards[]) {
+  uint8_t *record = (uint8_t *)reach;
+  store_wait();
+  uint8_t len = scores_pack(boards, NUM_MODES, record + LOG_HEADER_LEN, LOG_PAYLOAD_LEN);
+  log_append(record, len);
+}
+
+bool is_high_score_eligable(uint16_t current_points, highscores &highscores_table) {
+  return current_points > 0 && high_score_rank(current_points, highscores_table) < NUM_HI_SCORES;
 }
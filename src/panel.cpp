@@ -0,0 +1,225 @@
+#include "panel.h"
+
+#if PANEL_BENCHMARK && !defined(__AVR__)
+#include <time.h>
+#endif
+
+static RGBmatrixPanel *panel = NULL;
+
+bool panel_dirty = false;
+
+// Bits left alone when writing a pixel: they belong to the row sharing its
+// bytes in the other half of the panel.
+static const uint8_t panel_keep[2][3] = {
+  { (uint8_t)~0x1C, (uint8_t)~0x1D, (uint8_t)~0x1F },
+  { (uint8_t)~0xE3, (uint8_t)~0xE2, (uint8_t)~0xE0 },
+};
+
+void panel_begin(RGBmatrixPanel &target) {
+  panel = &target;
+}
+
+// Shows what was drawn since the last call. swapBuffers() waits for the
+// refresh interrupt to finish its frame, at most one frame, then copies the
+// shown buffer back so screens keep redrawing only what changed.
+void panel_present() {
+#if PANEL_DOUBLE_BUFFER
+  if (!panel_dirty) return;
+  panel_dirty = false;
+  panel->swapBuffers(true);
+#endif
+}
+
+static uint8_t plane_bits(uint8_t r, uint8_t g, uint8_t b, uint8_t bit) {
+  return ((r & bit) ? 1 : 0) | ((g & bit) ? 2 : 0) | ((b & bit) ? 4 : 0);
+}
+
+// Same unpacking of the 5/6/5 colour as RGBmatrixPanel::drawPixel().
+panel_ink panel_ink_for(uint16_t color) {
+  uint8_t r = color >> 12;
+  uint8_t g = (color >> 7) & 0xF;
+  uint8_t b = (color >> 1) & 0xF;
+  panel_ink ink;
+  ink.set[0][0] = plane_bits(r, g, b, 2) << 2;
+  ink.set[0][1] = plane_bits(r, g, b, 4) << 2 | (b & 1);
+  ink.set[0][2] = plane_bits(r, g, b, 8) << 2 | (r & 1) | (g & 1) << 1;
+  ink.set[1][0] = plane_bits(r, g, b, 2) << 5 | (g & 1) | (b & 1) << 1;
+  ink.set[1][1] = plane_bits(r, g, b, 4) << 5 | (r & 1) << 1;
+  ink.set[1][2] = plane_bits(r, g, b, 8) << 5;
+  return ink;
+}
+
+static inline uint8_t *row_start(int16_t y) {
+  panel_dirty = true;
+  return panel->backBuffer() + (y & (PANEL_HEIGHT / 2 - 1)) * PANEL_WIDTH * 3;
+}
+
+static inline void put(uint8_t *ptr, const uint8_t *keep, const uint8_t *set) {
+  ptr[0] = (ptr[0] & keep[0]) | set[0];
+  ptr[PANEL_WIDTH] = (ptr[PANEL_WIDTH] & keep[1]) | set[1];
+  ptr[PANEL_WIDTH * 2] = (ptr[PANEL_WIDTH * 2] & keep[2]) | set[2];
+}
+
+void panel_pixel(int16_t x, int16_t y, const panel_ink &ink) {
+  if (x < 0 || y < 0 || x >= PANEL_WIDTH || y >= PANEL_HEIGHT) return;
+  uint8_t half = y >= PANEL_HEIGHT / 2;
+  put(row_start(y) + x, panel_keep[half], ink.set[half]);
+}
+
+// Draws the set bits of one byte, leftmost pixel in the high bit, from x.
+void panel_row(int16_t x, int16_t y, uint8_t bits, const panel_ink &ink) {
+  if (y < 0 || y >= PANEL_HEIGHT) return;
+  uint8_t half = y >= PANEL_HEIGHT / 2;
+  uint8_t *row = row_start(y);
+  for (; bits != 0; bits <<= 1, x++) {
+    if (!(bits & 0x80) || x < 0 || x >= PANEL_WIDTH) continue;
+    put(row + x, panel_keep[half], ink.set[half]);
+  }
+}
+
+// Same as panel_row(), with the clear bits drawn in bg.
+void panel_row_opaque(int16_t x, int16_t y, uint8_t bits, const panel_ink &ink, const panel_ink &bg) {
+  if (y < 0 || y >= PANEL_HEIGHT) return;
+  uint8_t half = y >= PANEL_HEIGHT / 2;
+  uint8_t *row = row_start(y);
+  for (uint8_t i = 0; i < 8; i++, bits <<= 1, x++) {
+    if (x < 0 || x >= PANEL_WIDTH) continue;
+    put(row + x, panel_keep[half], (bits & 0x80) ? ink.set[half] : bg.set[half]);
+  }
+}
+
+void panel_span(int16_t x, int16_t y, int16_t w, const panel_ink &ink) {
+  if (y < 0 || y >= PANEL_HEIGHT) return;
+  if (x < 0) {
+    w += x;
+    x = 0;
+  }
+  if (x + w > PANEL_WIDTH) w = PANEL_WIDTH - x;
+  if (w <= 0) return;
+  uint8_t half = y >= PANEL_HEIGHT / 2;
+  uint8_t *ptr = row_start(y) + x;
+  while (w-- > 0) put(ptr++, panel_keep[half], ink.set[half]);
+}
+
+void panel_vspan(int16_t x, int16_t y, int16_t h, const panel_ink &ink) {
+  if (x < 0 || x >= PANEL_WIDTH) return;
+  if (y < 0) {
+    h += y;
+    y = 0;
+  }
+  if (y + h > PANEL_HEIGHT) h = PANEL_HEIGHT - y;
+  for (; h > 0; h--, y++) {
+    uint8_t half = y >= PANEL_HEIGHT / 2;
+    put(row_start(y) + x, panel_keep[half], ink.set[half]);
+  }
+}
+
+void panel_fill(int16_t x, int16_t y, int16_t w, int16_t h, const panel_ink &ink) {
+  for (int16_t row = y; row < y + h; row++) panel_span(x, row, w, ink);
+}
+
+void panel_rect(int16_t x, int16_t y, int16_t w, int16_t h, const panel_ink &ink) {
+  panel_span(x, y, w, ink);
+  panel_span(x, y + h - 1, w, ink);
+  panel_vspan(x, y + 1, h - 2, ink);
+  panel_vspan(x + w - 1, y + 1, h - 2, ink);
+}
+
+// PROGMEM bitmap in drawBitmap()'s layout: rows padded to whole bytes,
+// leftmost pixel in the high bit. Clear bits are left untouched.
+void panel_bitmap(int16_t x, int16_t y, const uint8_t *bitmap, int16_t w, int16_t h, const panel_ink &ink) {
+  uint8_t stride = (w + 7) / 8;
+  for (int16_t row = 0; row < h; row++) {
+    for (uint8_t i = 0; i < stride; i++) {
+      uint8_t bits = pgm_read_byte(bitmap + row * stride + i);
+      if (i == stride - 1 && (w & 7) != 0) bits &= 0xFF << (8 - (w & 7));
+      if (bits != 0) panel_row(x + i * 8, y + row, bits, ink);
+    }
+  }
+}
+
+#if PANEL_BENCHMARK
+
+#define BENCH_ROUNDS 16
+
+static const uint8_t bench_bitmap[] PROGMEM = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+#ifdef __AVR__
+static unsigned long bench_now() {
+  return micros();
+}
+#else
+// micros() only follows the virtual clock on the host.
+static unsigned long bench_now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+}
+#endif
+
+static unsigned long pixels_per_second(unsigned long pixels, unsigned long us) {
+  return us ? (unsigned long)(pixels * 1000000ULL / us) : 0;
+}
+
+static void bench_report(const __FlashStringHelper *name, unsigned long pixels, unsigned long gfx_us, unsigned long direct_us) {
+  Serial.print(F("B "));
+  Serial.print(name);
+  Serial.print(' ');
+  Serial.print(pixels_per_second(pixels, gfx_us), HEX);
+  Serial.print(' ');
+  Serial.println(pixels_per_second(pixels, direct_us), HEX);
+}
+
+// Draws the same pixels through both paths with interrupts on, so the
+// panel refresh takes its usual share. Leaves the screen cleared.
+void panel_benchmark() {
+  uint16_t color = panel->Color444(3, 5, 7);
+  panel_ink ink = panel_ink_for(color);
+  unsigned long start, gfx_us, direct_us;
+
+  start = bench_now();
+  for (uint8_t n = 0; n < BENCH_ROUNDS; n++) {
+    for (int16_t y = 0; y < PANEL_HEIGHT; y++) {
+      for (int16_t x = 0; x < PANEL_WIDTH; x++) panel->drawPixel(x, y, color);
+    }
+  }
+  gfx_us = bench_now() - start;
+  start = bench_now();
+  for (uint8_t n = 0; n < BENCH_ROUNDS; n++) {
+    for (int16_t y = 0; y < PANEL_HEIGHT; y++) {
+      for (int16_t x = 0; x < PANEL_WIDTH; x++) panel_pixel(x, y, ink);
+    }
+  }
+  direct_us = bench_now() - start;
+  bench_report(F("pixel"), BENCH_ROUNDS * 2048UL, gfx_us, direct_us);
+
+  start = bench_now();
+  for (uint8_t n = 0; n < BENCH_ROUNDS; n++) {
+    for (int16_t y = 0; y < PANEL_HEIGHT; y++) panel->drawFastHLine(0, y, PANEL_WIDTH, color);
+  }
+  gfx_us = bench_now() - start;
+  start = bench_now();
+  for (uint8_t n = 0; n < BENCH_ROUNDS; n++) {
+    for (int16_t y = 0; y < PANEL_HEIGHT; y++) panel_span(0, y, PANEL_WIDTH, ink);
+  }
+  direct_us = bench_now() - start;
+  bench_report(F("span"), BENCH_ROUNDS * 2048UL, gfx_us, direct_us);
+
+  start = bench_now();
+  for (uint8_t n = 0; n < BENCH_ROUNDS; n++) {
+    for (int16_t y = 0; y < PANEL_HEIGHT; y++) panel->drawBitmap(0, y, bench_bitmap, PANEL_WIDTH, 1, color);
+  }
+  gfx_us = bench_now() - start;
+  start = bench_now();
+  for (uint8_t n = 0; n < BENCH_ROUNDS; n++) {
+    for (int16_t y = 0; y < PANEL_HEIGHT; y++) panel_bitmap(0, y, bench_bitmap, PANEL_WIDTH, 1, ink);
+  }
+  direct_us = bench_now() - start;
+  bench_report(F("bitmap"), BENCH_ROUNDS * 2048UL, gfx_us, direct_us);
+
+  panel->fillScreen(0);
+}
+
+#endif
@@ -0,0 +1,113 @@
+#include "profile.h"
+#include "panel.h"
+
+#if PROFILE
+
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#else
+#include <time.h>
+#endif
+
+typedef struct {
+  uint32_t calls;
+  uint32_t total;
+  uint32_t worst;
+} profile_zone;
+
+static const char zone_names[PROF_ZONES][5] PROGMEM = { "tick", "move", "hit", "draw", "food", "text", "fill" };
+
+static profile_zone zones[PROF_ZONES];
+
+#ifdef __AVR__
+#define CALIBRATION_LOOPS 1500
+
+static volatile uint16_t overflows = 0;
+
+ISR(TIMER5_OVF_vect) {
+  overflows++;
+}
+
+uint32_t profile_now() {
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t low = TCNT5;
+  uint16_t high = overflows;
+  // An overflow not yet serviced belongs to a counter that has wrapped.
+  if ((TIFR5 & _BV(TOV5)) && low < 0x8000) high++;
+  SREG = sreg;
+  return ((uint32_t)high << 16) | low;
+}
+
+static uint32_t calibration_run() {
+  uint32_t start = profile_now();
+  for (volatile uint16_t i = 0; i < CALIBRATION_LOOPS; i++) {
+  }
+  return profile_now() - start;
+}
+
+// The same busy loop timed with interrupts off and on; the difference is
+// what the interrupts took.
+static uint16_t isr_permille() {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t quiet = calibration_run();
+  SREG = sreg;
+  uint32_t busy = calibration_run();
+  if (busy <= quiet) return 0;
+  return (uint32_t)(busy - quiet) * 1000 / busy;
+}
+
+void profile_begin() {
+  TCCR5A = 0;
+  TCCR5B = _BV(CS50);
+  TIMSK5 = _BV(TOIE5);
+  memset(zones, 0, sizeof(zones));
+}
+#else
+uint32_t profile_now() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint32_t)(now.tv_sec * 1000000000ULL + now.tv_nsec);
+}
+
+static uint16_t isr_permille() {
+  return 0;
+}
+
+void profile_begin() {
+  memset(zones, 0, sizeof(zones));
+}
+#endif
+
+void profile_add(uint8_t zone, uint32_t start) {
+  uint32_t spent = profile_now() - start;
+  zones[zone].calls++;
+  zones[zone].total += spent;
+  if (spent > zones[zone].worst) zones[zone].worst = spent;
+}
+
+void profile_report(uint8_t screen) {
+  uint32_t calls = 0;
+  for (uint8_t i = 0; i < PROF_ZONES; i++) calls |= zones[i].calls;
+  if (calls == 0) return;
+  Serial.print(F("Q screen "));
+  Serial.println(screen, HEX);
+  for (uint8_t i = 0; i < PROF_ZONES; i++) {
+    Serial.print(F("Q "));
+    Serial.print((const __FlashStringHelper *)zone_names[i]);
+    Serial.print(' ');
+    Serial.print(zones[i].calls, HEX);
+    Serial.print(' ');
+    Serial.print(zones[i].total, HEX);
+    Serial.print(' ');
+    Serial.println(zones[i].worst, HEX);
+  }
+  Serial.print(F("Q isr "));
+  Serial.print(isr_permille(), HEX);
+  Serial.print(' ');
+  Serial.println(PANEL_PLANES, HEX);
+  memset(zones, 0, sizeof(zones));
+}
+
+#endif
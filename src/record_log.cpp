@@ -0,0 +1,108 @@
+#include "record_log.h"
+#include "eeprom_store.h"
+
+#include <EEPROM.h>
+
+// Slot of the newest valid record and its sequence number; head is
+// LOG_SLOTS when the log is empty.
+static uint8_t log_head = LOG_SLOTS;
+static uint16_t log_seq = 0;
+
+static int slot_address(uint8_t slot, uint8_t slot_len) {
+  return LOG_START + slot * slot_len;
+}
+
+static uint16_t slot_seq(uint8_t slot, uint8_t slot_len) {
+  uint16_t seq;
+  EEPROM.get(slot_address(slot, slot_len), seq);
+  return seq;
+}
+
+static bool slot_valid(uint8_t slot, uint8_t slot_len) {
+  int address = slot_address(slot, slot_len);
+  uint16_t seq = slot_seq(slot, slot_len);
+  uint16_t stored_crc;
+  EEPROM.get(address + 2, stored_crc);
+  uint16_t crc = store_crc(0, &seq, 2);
+  for (uint8_t i = 0; i < slot_len - LOG_HEADER_LEN; i++) {
+    uint8_t b = EEPROM.read(address + LOG_HEADER_LEN + i);
+    crc = store_crc(crc, &b, 1);
+  }
+  return crc == stored_crc;
+}
+
+// Marks every slot empty. Only headers that are not erased yet are written.
+void log_format() {
+  store_wait();
+  for (uint8_t slot = 0; slot < LOG_SLOTS; slot++) {
+    if (slot_seq(slot, LOG_SLOT_LEN) != LOG_ERASED) {
+      EEPROM.put(slot_address(slot, LOG_SLOT_LEN), (uint16_t)LOG_ERASED);
+    }
+  }
+  log_head = LOG_SLOTS;
+  log_seq = 0;
+}
+
+// Slot of the newest valid record in a log of slots of slot_len bytes, or
+// the slot count when there is none; seq gets the newest sequence number.
+static uint8_t newest_slot(uint8_t slot_len, uint16_t &seq) {
+  uint8_t slots = (4096 - LOG_START) / slot_len;
+  uint8_t newest = slots;
+  seq = 0;
+  for (uint8_t slot = 0; slot < slots; slot++) {
+    uint16_t slot_number = slot_seq(slot, slot_len);
+    if (slot_number == LOG_ERASED) continue;
+    if (newest == slots || (int16_t)(slot_number - seq) > 0) {
+      newest = slot;
+      seq = slot_number;
+    }
+  }
+  if (newest == slots) return slots;
+  uint8_t slot = newest;
+  for (uint8_t tries = 0; tries < slots; tries++) {
+    if (slot_seq(slot, slot_len) == LOG_ERASED) break;
+    if (slot_valid(slot, slot_len)) return slot;
+    slot = slot == 0 ? slots - 1 : slot - 1;
+  }
+  return slots;
+}
+
+bool log_mount() {
+  log_head = newest_slot(LOG_SLOT_LEN, log_seq);
+  return log_head != LOG_SLOTS;
+}
+
+static void read_payload(uint8_t slot, uint8_t slot_len, void *data, uint8_t len) {
+  if (len > slot_len - LOG_HEADER_LEN) len = slot_len - LOG_HEADER_LEN;
+  uint8_t *bytes = (uint8_t *)data;
+  for (uint8_t i = 0; i < len; i++) {
+    bytes[i] = EEPROM.read(slot_address(slot, slot_len) + LOG_HEADER_LEN + i);
+  }
+}
+
+bool log_read(void *data, uint8_t len) {
+  if (log_head == LOG_SLOTS) return false;
+  read_payload(log_head, LOG_SLOT_LEN, data, len);
+  return true;
+}
+
+bool log_read_legacy(uint8_t slot_len, void *data, uint8_t len) {
+  uint16_t seq;
+  uint8_t slot = newest_slot(slot_len, seq);
+  if (slot == (4096 - LOG_START) / slot_len) return false;
+  read_payload(slot, slot_len, data, len);
+  return true;
+}
+
+void log_append(uint8_t record[], uint8_t len) {
+  store_wait();
+  if (len > LOG_PAYLOAD_LEN) len = LOG_PAYLOAD_LEN;
+  memset(record + LOG_HEADER_LEN + len, 0, LOG_PAYLOAD_LEN - len);
+  log_seq++;
+  if (log_seq == LOG_ERASED) log_seq = 0;
+  log_head = log_head >= LOG_SLOTS - 1 ? 0 : log_head + 1;
+  uint16_t crc = store_crc(store_crc(0, &log_seq, 2), record + LOG_HEADER_LEN, LOG_PAYLOAD_LEN);
+  memcpy(record, &log_seq, 2);
+  memcpy(record + 2, &crc, 2);
+  store_put(slot_address(log_head, LOG_SLOT_LEN), record, LOG_SLOT_LEN);
+}
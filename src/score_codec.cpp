@@ -0,0 +1,100 @@
+#include "score_codec.h"
+
+const char name_letters[NAME_LETTERS] PROGMEM = {
+  'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
+  'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
+  '0', '1', '2', '3', '4', '5', '6', '7', '8', '9',
+  ' ', '_', '.', '@', '!', '?', ':'
+};
+
+typedef struct {
+  uint8_t *data;
+  uint16_t bit;
+  uint16_t limit;
+} bit_stream;
+
+// LSB first. Writes past the end only mark the stream as overflowed.
+static void bits_put(bit_stream &s, uint16_t value, uint8_t bits) {
+  for (uint8_t i = 0; i < bits; i++, s.bit++) {
+    if (s.bit >= s.limit) continue;
+    uint8_t mask = 1 << (s.bit & 7);
+    if (value & (1 << i)) s.data[s.bit >> 3] |= mask;
+    else s.data[s.bit >> 3] &= ~mask;
+  }
+}
+
+static uint16_t bits_get(bit_stream &s, uint8_t bits) {
+  uint16_t value = 0;
+  for (uint8_t i = 0; i < bits; i++, s.bit++) {
+    if (s.bit < s.limit && (s.data[s.bit >> 3] & (1 << (s.bit & 7)))) value |= 1 << i;
+  }
+  return value;
+}
+
+// Up to SCORE_MAX; the second byte has no flag of its own.
+static void varint_put(bit_stream &s, uint16_t value) {
+  bits_put(s, (value & 0x7F) | (value > 0x7F ? 0x80 : 0), 8);
+  if (value > 0x7F) bits_put(s, value >> 7, 8);
+}
+
+static uint16_t varint_get(bit_stream &s) {
+  uint16_t value = bits_get(s, 8);
+  if (value & 0x80) value = (value & 0x7F) | bits_get(s, 8) << 7;
+  return value;
+}
+
+static uint8_t letter_index(char c) {
+  for (uint8_t i = 0; i < NAME_LETTERS; i++) {
+    if (pgm_read_byte(&name_letters[i]) == c) return i;
+  }
+  return NAME_END;
+}
+
+// Returns the bytes used, or 0 when the boards do not fit in len.
+uint8_t scores_pack(const highscores boards[], uint8_t count, uint8_t *out, uint8_t len) {
+  bit_stream s = { out, 0, (uint16_t)(len * 8) };
+  bits_put(s, count, 8);
+  for (uint8_t b = 0; b < count; b++) {
+    const highscore_entry *entries = boards[b].scores;
+    uint8_t used = 0;
+    while (used < NUM_HI_SCORES && entries[used].points > 0) used++;
+    varint_put(s, used);
+    uint16_t above = 0;
+    for (uint8_t i = 0; i < used; i++) {
+      bool ended = false;
+      for (uint8_t c = 0; c < NAME_LEN; c++) {
+        ended = ended || entries[i].name[c] == '\0';
+        bits_put(s, ended ? NAME_END : letter_index(entries[i].name[c]), 7);
+      }
+      varint_put(s, i == 0 ? entries[i].points : above - entries[i].points);
+      above = entries[i].points;
+    }
+  }
+  if (s.bit > s.limit) return 0;
+  return (s.bit + 7) / 8;
+}
+
+bool scores_unpack(const uint8_t *in, uint8_t len, highscores boards[], uint8_t count) {
+  bit_stream s = { (uint8_t *)in, 0, (uint16_t)(len * 8) };
+  uint8_t stored = bits_get(s, 8);
+  for (uint8_t b = 0; b < count; b++) {
+    boards[b] = highscores();
+  }
+  for (uint8_t b = 0; b < stored; b++) {
+    uint16_t used = varint_get(s);
+    uint16_t above = 0;
+    for (uint16_t i = 0; i < used; i++) {
+      highscore_entry entry;
+      for (uint8_t c = 0; c < NAME_LEN; c++) {
+        uint8_t index = bits_get(s, 7);
+        entry.name[c] = index < NAME_LETTERS ? pgm_read_byte(&name_letters[index]) : '\0';
+      }
+      entry.points = i == 0 ? varint_get(s) : above - varint_get(s);
+      above = entry.points;
+      // Boards of modes this build does not know, and entries past its
+      // capacity, are skipped.
+      if (b < count && i < NUM_HI_SCORES) boards[b].scores[i] = entry;
+    }
+  }
+  return s.bit <= s.limit;
+}
@@ -0,0 +1,162 @@
+#include "session.h"
+#include "game.h"
+#include "tick_clock.h"
+
+#ifndef __AVR__
+#include <stdio.h>
+#include <time.h>
+#endif
+
+#if SESSION_LOG || !defined(__AVR__)
+static uint16_t session_crc = 0;
+#endif
+
+#if SESSION_LOG
+static bool session_replaying = false;
+static int session_dir = 0;
+
+static char dir_letter(int dir) {
+  return dir == DIR_UP ? 'U' : (dir == DIR_RIGHT ? 'R' : (dir == DIR_DOWN ? 'D' : 'L'));
+}
+
+void session_begin(unsigned long seed) {
+  if (session_replaying) return;
+  session_crc = 0;
+  session_dir = 0;
+  Serial.print(F("S "));
+  Serial.println(seed, HEX);
+}
+
+void session_input(unsigned long tick, int dir, bool turbo, bool pause_toggled) {
+  bool turned = dir != session_dir;
+  if (!turned && !turbo && !pause_toggled) return;
+  session_dir = dir;
+  Serial.print(F("I "));
+  Serial.print(tick, HEX);
+  Serial.print(' ');
+  if (turned) Serial.print(dir_letter(dir));
+  if (turbo) Serial.print('T');
+  if (pause_toggled) Serial.print('P');
+  Serial.println();
+}
+
+void session_tick(unsigned long tick, uint8_t state) {
+  session_crc = game_checksum(session_crc);
+  if (state != GAME_RUNNING) {
+    Serial.print(F("E "));
+    Serial.print(tick, HEX);
+    Serial.print(' ');
+    Serial.print(session_crc, HEX);
+    Serial.print(' ');
+    Serial.println(points, HEX);
+  } else if ((tick + 1) % SESSION_CHECK_EVERY == 0) {
+    Serial.print(F("C "));
+    Serial.print(tick, HEX);
+    Serial.print(' ');
+    Serial.println(session_crc, HEX);
+  }
+}
+
+void session_timing() {
+  if (session_replaying) return;
+  const unsigned long fields[] = {
+    tick_jitter.ticks, tick_jitter.min_us, tick_jitter_percentile(50),
+    tick_jitter_percentile(99), tick_jitter.max_us, tick_jitter.resyncs
+  };
+  Serial.print('J');
+  for (unsigned int i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+    Serial.print(' ');
+    Serial.print(fields[i], HEX);
+  }
+  Serial.println();
+}
+
+void session_idle(unsigned long window_ms, unsigned long asleep_ms, unsigned long wakeups) {
+  if (session_replaying) return;
+  Serial.print(F("Z "));
+  Serial.print(window_ms, HEX);
+  Serial.print(' ');
+  Serial.print(asleep_ms, HEX);
+  Serial.print(' ');
+  Serial.println(wakeups, HEX);
+}
+#endif
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef __AVR__
+static snake_cell replay_snake[SNAKE_CELLS];
+static unsigned long replay_ticks = 0;
+static uint8_t replay_state = GAME_RUNNING;
+
+// Runs the game up to and including the given tick. False if it ended sooner.
+static bool replay_until(unsigned long tick) {
+  while (replay_ticks <= tick) {
+    if (replay_state != GAME_RUNNING) return false;
+    replay_state = game_tick(replay_snake);
+    session_crc = game_checksum(session_crc);
+    replay_ticks++;
+  }
+  return true;
+}
+
+int session_replay(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    fprintf(stderr, "replay: cannot open %s\n", path);
+    return 2;
+  }
+  struct timespec started, ended;
+  clock_gettime(CLOCK_MONOTONIC, &started);
+#if SESSION_LOG
+  session_replaying = true;
+#endif
+
+  char line[64];
+  unsigned int games = 0, checks = 0, failures = 0;
+  unsigned long total_ticks = 0;
+  bool in_game = false;
+  while (fgets(line, sizeof(line), f)) {
+    unsigned long seed, tick, crc, score;
+    char events[8];
+    if (sscanf(line, "S %lx", &seed) == 1) {
+      if (in_game) total_ticks += replay_ticks;
+      start_game(replay_snake, seed);
+      session_crc = 0;
+      replay_ticks = 0;
+      replay_state = GAME_RUNNING;
+      in_game = true;
+      games++;
+    } else if (!in_game) {
+      continue;
+    } else if (sscanf(line, "I %lx %7s", &tick, events) == 2) {
+      if (tick > 0 && !replay_until(tick - 1)) failures++;
+      for (char *e = events; *e; e++) {
+        if (*e == 'U') snake_next_dir = DIR_UP;
+        else if (*e == 'R') snake_next_dir = DIR_RIGHT;
+        else if (*e == 'D') snake_next_dir = DIR_DOWN;
+        else if (*e == 'L') snake_next_dir = DIR_LEFT;
+      }
+    } else if (sscanf(line, "C %lx %lx", &tick, &crc) == 2) {
+      checks++;
+      if (!replay_until(tick) || session_crc != crc) {
+        fprintf(stderr, "replay: game %u diverged by tick %lu\n", games, tick);
+        failures++;
+      }
+    } else if (sscanf(line, "E %lx %lx %lx", &tick, &crc, &score) == 3) {
+      checks++;
+      bool ok = replay_until(tick) && replay_state != GAME_RUNNING && session_crc == crc && points == score;
+      if (!ok) failures++;
+      printf("game %u: %lu ticks, %u points, %s\n", games, tick + 1, points, ok ? "match" : "MISMATCH");
+      total_ticks += replay_ticks;
+      in_game = false;
+    }
+  }
+  fclose(f);
+  clock_gettime(CLOCK_MONOTONIC, &ended);
+  double ms = (ended.tv_sec - started.tv_sec) * 1e3 + (ended.tv_nsec - started.tv_nsec) / 1e6;
+  printf("replayed %u games, %lu ticks, %u checksums in %.1f ms: %s\n", games, total_ticks, checks, ms,
+         failures ? "FAILED" : "ok");
+  return failures ? 1 : 0;
+}
+#endif
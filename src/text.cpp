@@ -0,0 +1,73 @@
+#include "text.h"
+#include "panel.h"
+
+static void load_font(uint8_t font, atlas_font &f) {
+  memcpy_P(&f, &atlas_fonts[font], sizeof(f));
+}
+
+static int16_t draw_glyph(const atlas_font &f, int16_t x, int16_t y, char c, const panel_ink &ink) {
+  uint8_t code = c;
+  if (code < f.first || code > f.last) return x;
+  uint8_t index = code - f.first;
+  const uint8_t *rows = f.rows + index * f.height;
+  y += f.top;
+  for (uint8_t row = 0; row < f.height; row++) {
+    uint8_t bits = pgm_read_byte(rows + row);
+    if (bits != 0) panel_row(x, y + row, bits, ink);
+  }
+  return x + pgm_read_byte(f.advance + index);
+}
+
+// Returns the x following the last glyph.
+int16_t text_draw(uint8_t font, int16_t x, int16_t y, const char *text, uint16_t color) {
+  atlas_font f;
+  load_font(font, f);
+  panel_ink ink = panel_ink_for(color);
+  for (; *text != '\0'; text++) x = draw_glyph(f, x, y, *text, ink);
+  return x;
+}
+
+// text_draw() for a string in flash (PSTR()).
+int16_t text_draw_P(uint8_t font, int16_t x, int16_t y, PGM_P text, uint16_t color) {
+  atlas_font f;
+  load_font(font, f);
+  panel_ink ink = panel_ink_for(color);
+  for (char c; (c = pgm_read_byte(text)) != '\0'; text++) x = draw_glyph(f, x, y, c, ink);
+  return x;
+}
+
+static char *format_number(char *end, uint16_t number) {
+  *end = '\0';
+  do {
+    *--end = '0' + number % 10;
+    number /= 10;
+  } while (number != 0);
+  return end;
+}
+
+int16_t text_draw_number(uint8_t font, int16_t x, int16_t y, uint16_t number, uint16_t color) {
+  char digits[6];
+  return text_draw(font, x, y, format_number(digits + 5, number), color);
+}
+
+// One row of a glyph's atlas cell, counted from the top of the cell; 0
+// outside the cell or the font.
+uint8_t text_glyph_row(uint8_t font, char c, int8_t row) {
+  atlas_font f;
+  load_font(font, f);
+  uint8_t code = c;
+  if (code < f.first || code > f.last || row < 0 || row >= f.height) return 0;
+  return pgm_read_byte(f.rows + (code - f.first) * f.height + row);
+}
+
+uint8_t text_number_width(uint8_t font, uint16_t number) {
+  atlas_font f;
+  load_font(font, f);
+  uint8_t width = 0;
+  do {
+    uint8_t code = '0' + number % 10;
+    if (code >= f.first && code <= f.last) width += pgm_read_byte(f.advance + code - f.first);
+    number /= 10;
+  } while (number != 0);
+  return width;
+}
@@ -0,0 +1,62 @@
+#include "tick_clock.h"
+
+tick_stats tick_jitter = { 0, 0, 0xFFFFFFFFUL, 0, { 0 } };
+
+static unsigned long tick_deadline = 0;
+static uint16_t tick_samples = 0;
+
+static void record_jitter(unsigned long late_us) {
+  if (late_us < tick_jitter.min_us) tick_jitter.min_us = late_us;
+  if (late_us > tick_jitter.max_us) tick_jitter.max_us = late_us;
+  tick_jitter.ticks++;
+  // Halving on overflow keeps the shape of the distribution.
+  if (tick_samples == 0xFFFF) {
+    tick_samples = 0;
+    for (uint8_t i = 0; i < TICK_JITTER_BUCKETS; i++) {
+      tick_jitter.histogram[i] /= 2;
+      tick_samples += tick_jitter.histogram[i];
+    }
+  }
+  unsigned long bucket = late_us / TICK_JITTER_STEP_US;
+  if (bucket >= TICK_JITTER_BUCKETS) bucket = TICK_JITTER_BUCKETS - 1;
+  tick_jitter.histogram[bucket]++;
+  tick_samples++;
+}
+
+void tick_start(unsigned long period_us) {
+  tick_deadline = micros() + period_us;
+}
+
+bool tick_due() {
+  unsigned long late_us = (uint32_t)(micros() - tick_deadline);
+  if ((int32_t)late_us < 0) return false;
+  record_jitter(late_us);
+  return true;
+}
+
+void tick_schedule(unsigned long period_us) {
+  tick_deadline += period_us;
+  unsigned long now = micros();
+  if ((int32_t)(now - tick_deadline) > (int32_t)(TICK_MAX_LAG * period_us)) {
+    tick_deadline = now + period_us;
+    tick_jitter.resyncs++;
+  }
+}
+
+void tick_hold(unsigned long period_us) {
+  tick_deadline = micros() + period_us;
+}
+
+// Upper edge of the bucket holding the given percentile, or the maximum
+// when it falls in the overflow bucket.
+unsigned long tick_jitter_percentile(uint8_t percent) {
+  unsigned long wanted = ((unsigned long)tick_samples * percent + 99) / 100;
+  unsigned long seen = 0;
+  for (uint8_t i = 0; i < TICK_JITTER_BUCKETS; i++) {
+    seen += tick_jitter.histogram[i];
+    if (seen >= wanted && seen > 0) {
+      return i == TICK_JITTER_BUCKETS - 1 ? tick_jitter.max_us : (unsigned long)(i + 1) * TICK_JITTER_STEP_US;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include <unity.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bitboard.h"
+#include "game.h"
+
+#define CELLS (64 * BITBOARD_ROWS)
+
+static uint8_t walls[BOARD_BYTES];
+static uint64_t bits[BITBOARD_ROWS];
+// Steps from the start cell as found by a breadth-first search, -1 where
+// it never gets.
+static int16_t distance[CELLS];
+
+static bool is_wall(unsigned int pos) {
+  return walls[pos >> 3] & 1 << (pos & 7);
+}
+
+static uint64_t free_row(uint8_t y) {
+  uint64_t row;
+  memcpy(&row, walls + y * 8, sizeof(row));
+  return ~row;
+}
+
+// A bordered field with a random share of walls, up to 70% and often
+// almost none, and a start cell inside it that is itself blocked, as the
+// snake's head is.
+static unsigned int random_field() {
+  memset(walls, 0, sizeof(walls));
+  int density = rand() % 4 == 0 ? rand() % 3 : rand() % 70;
+  for (unsigned int pos = 0; pos < CELLS; pos++) {
+    uint8_t x = GET_X(pos), y = GET_Y(pos);
+    bool border = x == 0 || x == 63 || y == 0 || y == BITBOARD_ROWS - 1;
+    if (border || rand() % 100 < density) walls[pos >> 3] |= 1 << (pos & 7);
+  }
+  unsigned int from = GET_POS(1 + rand() % 62, 1 + rand() % (BITBOARD_ROWS - 2));
+  walls[from >> 3] |= 1 << (from & 7);
+  return from;
+}
+
+// Returns how many cells other than the start are reachable.
+static unsigned int search(unsigned int from) {
+  static uint16_t queue[CELLS];
+  static const int8_t steps[4] = { DIR_UP, DIR_RIGHT, DIR_DOWN, DIR_LEFT };
+  for (unsigned int pos = 0; pos < CELLS; pos++) distance[pos] = -1;
+  unsigned int head = 0, tail = 0, found = 0;
+  distance[from] = 0;
+  queue[tail++] = from;
+  while (head < tail) {
+    unsigned int pos = queue[head++];
+    for (uint8_t d = 0; d < 4; d++) {
+      unsigned int next = pos + steps[d];
+      if (distance[next] >= 0 || is_wall(next)) continue;
+      distance[next] = distance[pos] + 1;
+      queue[tail++] = next;
+      found++;
+    }
+  }
+  return found;
+}
+
+void setUp() {
+  srand(1);
+}
+
+void tearDown() {}
+
+void test_fill_matches_search() {
+  for (uint16_t run = 0; run < 5000; run++) {
+    unsigned int from = random_field();
+    unsigned int found = search(from);
+    TEST_ASSERT_EQUAL_UINT(found, bitboard_fill(bits, walls, from));
+    for (unsigned int pos = 0; pos < CELLS; pos++) {
+      TEST_ASSERT_TRUE(bitboard_test(bits, pos) == (pos != from && distance[pos] >= 0));
+    }
+  }
+}
+
+// Corridors along the rows, joined at alternating ends, are the worst case
+// for passes down and up the field.
+void test_fill_row_corridors() {
+  memset(walls, 0, sizeof(walls));
+  for (unsigned int pos = 0; pos < CELLS; pos++) {
+    uint8_t x = GET_X(pos), y = GET_Y(pos);
+    bool border = x == 0 || x == 63 || y == 0 || y == BITBOARD_ROWS - 1;
+    bool divider = y % 2 == 0 && x != (y % 4 == 0 ? 1 : 62);
+    if (border || divider) walls[pos >> 3] |= 1 << (pos & 7);
+  }
+  unsigned int from = GET_POS(62, 1);
+  walls[from >> 3] |= 1 << (from & 7);
+  unsigned int found = search(from);
+  TEST_ASSERT_EQUAL_UINT(found, bitboard_fill(bits, walls, from));
+  for (unsigned int pos = 0; pos < CELLS; pos++) {
+    TEST_ASSERT_TRUE(bitboard_test(bits, pos) == (pos != from && distance[pos] >= 0));
+  }
+}
+
+// Each wave adds exactly the cells one step further out. Waves start from
+// a free cell, the food.
+void test_waves_match_search() {
+  for (uint16_t run = 0; run < 500; run++) {
+    unsigned int from = random_field();
+    walls[from >> 3] &= ~(1 << (from & 7));
+    search(from);
+    bitboard_clear(bits);
+    bitboard_set(bits, from);
+    uint8_t first = GET_Y(from), last = GET_Y(from);
+    int16_t steps = 0;
+    while (bitboard_wave(bits, free_row, first, last)) {
+      steps++;
+      for (unsigned int pos = 0; pos < CELLS; pos++) {
+        bool reached = pos == from || (distance[pos] >= 0 && distance[pos] <= steps);
+        TEST_ASSERT_TRUE(bitboard_test(bits, pos) == reached);
+      }
+    }
+    for (unsigned int pos = 0; pos < CELLS; pos++) {
+      TEST_ASSERT_TRUE(distance[pos] <= steps);
+    }
+  }
+}
+
+// Counting and picking over the rows food goes to.
+void test_count_and_nth() {
+  const unsigned int first = GET_POS(1, 1), last = GET_POS(62, 14);
+  for (uint16_t run = 0; run < 5000; run++) {
+    unsigned int from = random_field();
+    search(from);
+    bitboard_fill(bits, walls, from);
+    unsigned int count = 0;
+    for (unsigned int pos = first; pos <= last; pos++) {
+      if (pos != from && distance[pos] >= 0) count++;
+    }
+    TEST_ASSERT_EQUAL_UINT(count, bitboard_count(bits, first, last));
+    if (count == 0) continue;
+    unsigned int n = rand() % count;
+    unsigned int expected = first;
+    for (unsigned int seen = 0;; expected++) {
+      if (expected == from || distance[expected] < 0) continue;
+      if (seen++ == n) break;
+    }
+    TEST_ASSERT_EQUAL_UINT(expected, bitboard_nth(bits, first, last, n));
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_fill_matches_search);
+  RUN_TEST(test_fill_row_corridors);
+  RUN_TEST(test_waves_match_search);
+  RUN_TEST(test_count_and_nth);
+  return UNITY_END();
+}
@@ -0,0 +1,89 @@
+#include <unity.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "score_codec.h"
+
+// A sorted board with random names and gaps, the first score anywhere up
+// to SCORE_MAX and half of the time exactly SCORE_MAX.
+static void random_board(highscores &board) {
+  board = highscores();
+  uint8_t used = rand() % (NUM_HI_SCORES + 1);
+  uint16_t points = rand() % 2 ? SCORE_MAX : rand() % (SCORE_MAX + 1);
+  for (uint8_t i = 0; i < used && points > 0; i++) {
+    uint8_t length = rand() % (NAME_LEN + 1);
+    for (uint8_t c = 0; c < length; c++) {
+      board.scores[i].name[c] = pgm_read_byte(&name_letters[rand() % NAME_LETTERS]);
+    }
+    board.scores[i].points = points;
+    uint16_t gap = rand() % 3 == 0 ? rand() % 128 : rand() % (points + 1);
+    points -= gap < points ? gap : points;
+  }
+}
+
+static void assert_boards_equal(const highscores *expected, const highscores *actual) {
+  for (uint8_t b = 0; b < NUM_MODES; b++) {
+    for (uint8_t i = 0; i < NUM_HI_SCORES; i++) {
+      const highscore_entry &e = expected[b].scores[i];
+      const highscore_entry &a = actual[b].scores[i];
+      TEST_ASSERT_EQUAL_UINT16(e.points, a.points);
+      if (e.points > 0) TEST_ASSERT_EQUAL_MEMORY(e.name, a.name, NAME_LEN);
+    }
+  }
+}
+
+void setUp() {
+  srand(1);
+}
+
+void tearDown() {}
+
+void test_random_boards_round_trip() {
+  for (uint16_t run = 0; run < 20000; run++) {
+    highscores boards[NUM_MODES], unpacked[NUM_MODES];
+    for (uint8_t b = 0; b < NUM_MODES; b++) random_board(boards[b]);
+    uint8_t packed[SCORES_PACKED_MAX];
+    uint8_t len = scores_pack(boards, NUM_MODES, packed, sizeof(packed));
+    TEST_ASSERT_NOT_EQUAL(0, len);
+    TEST_ASSERT_TRUE(scores_unpack(packed, len, unpacked, NUM_MODES));
+    assert_boards_equal(boards, unpacked);
+  }
+}
+
+// Full boards of full names with every gap too wide for one byte are the
+// worst case SCORES_PACKED_MAX is sized for.
+void test_worst_case_fits() {
+  highscores boards[NUM_MODES], unpacked[NUM_MODES];
+  for (uint8_t b = 0; b < NUM_MODES; b++) {
+    for (uint8_t i = 0; i < NUM_HI_SCORES; i++) {
+      memset(boards[b].scores[i].name, 'W', NAME_LEN);
+      boards[b].scores[i].points = SCORE_MAX - i * 128;
+    }
+  }
+  uint8_t packed[SCORES_PACKED_MAX];
+  TEST_ASSERT_EQUAL_UINT8(SCORES_PACKED_MAX, scores_pack(boards, NUM_MODES, packed, sizeof(packed)));
+  TEST_ASSERT_EQUAL_UINT8(0, scores_pack(boards, NUM_MODES, packed, sizeof(packed) - 1));
+  TEST_ASSERT_TRUE(scores_unpack(packed, sizeof(packed), unpacked, NUM_MODES));
+  assert_boards_equal(boards, unpacked);
+}
+
+void test_truncated_record_fails() {
+  highscores boards[NUM_MODES], unpacked[NUM_MODES];
+  for (uint8_t b = 0; b < NUM_MODES; b++) {
+    memcpy(boards[b].scores[0].name, "SNAKE", 5);
+    boards[b].scores[0].points = 1000;
+  }
+  uint8_t packed[SCORES_PACKED_MAX];
+  uint8_t len = scores_pack(boards, NUM_MODES, packed, sizeof(packed));
+  TEST_ASSERT_TRUE(scores_unpack(packed, len, unpacked, NUM_MODES));
+  TEST_ASSERT_FALSE(scores_unpack(packed, len - 1, unpacked, NUM_MODES));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_random_boards_round_trip);
+  RUN_TEST(test_worst_case_fits);
+  RUN_TEST(test_truncated_record_fails);
+  return UNITY_END();
+}
@@ -0,0 +1,252 @@
+#ifndef GOLDEN_LOG_H
+#define GOLDEN_LOG_H
+
+// Session log captured from the native build. The first game is a
+// scripted one that scores a point and crashes; the second is a demo game
+// from the attract mode, cut short after 3000 moves with 0xD9 points. It
+// replays only as long as game_tick() keeps the rules, the random sequence
+// and the food placement it was captured with: recapture it (program
+// --script, session log on stdout) after changing them on purpose.
+static const char golden_log[] =
+  "S 18D12\n"
+  "I 0 R\n"
+  "I 3 D\n"
+  "I 5 R\n"
+  "I 6 U\n"
+  "I B L\n"
+  "I C D\n"
+  "I D L\n"
+  "I F D\n"
+  "I 11 L\n"
+  "I 17 U\n"
+  "I 1B R\n"
+  "I 24 U\n"
+  "E 2E 9B65 1\n"
+  "S 12F8E02\n"
+  "I 0 R\n"
+  "I 1 D\n"
+  "I 4 L\n"
+  "I 7 D\n"
+  "I 9 L\n"
+  "I 25 U\n"
+  "I 2E R\n"
+  "I 33 D\n"
+  "I 34 L\n"
+  "I 39 U\n"
+  "C 3F 2973\n"
+  "I 42 R\n"
+  "I 70 D\n"
+  "I 73 L\n"
+  "C 7F BE6F\n"
+  "I 89 D\n"
+  "I 8B L\n"
+  "I A3 U\n"
+  "I A8 R\n"
+  "C BF B225\n"
+  "I CD D\n"
+  "I D4 L\n"
+  "I F4 D\n"
+  "I F7 R\n"
+  "I FE D\n"
+  "I FF L\n"
+  "C FF CEF\n"
+  "I 10B U\n"
+  "I 112 R\n"
+  "I 131 D\n"
+  "I 138 L\n"
+  "C 13F DE5\n"
+  "I 157 U\n"
+  "I 162 R\n"
+  "I 168 D\n"
+  "I 16C R\n"
+  "C 17F 1747\n"
+  "I 189 D\n"
+  "I 18A L\n"
+  "I 1AD U\n"
+  "I 1B0 R\n"
+  "C 1BF 1BC8\n"
+  "I 1D2 D\n"
+  "I 1D3 L\n"
+  "I 1F5 U\n"
+  "I 1F8 R\n"
+  "C 1FF 14FB\n"
+  "I 211 D\n"
+  "I 214 L\n"
+  "I 22A U\n"
+  "I 22B R\n"
+  "I 23C D\n"
+  "I 23D L\n"
+  "C 23F 172A\n"
+  "I 251 U\n"
+  "I 254 R\n"
+  "C 27F 6D82\n"
+  "I 286 D\n"
+  "I 291 L\n"
+  "C 2BF F3F2\n"
+  "I 2C3 U\n"
+  "I 2CA R\n"
+  "I 2E4 D\n"
+  "I 2E5 L\n"
+  "I 2F4 D\n"
+  "I 2F7 R\n"
+  "C 2FF 8372\n"
+  "I 329 D\n"
+  "I 32A L\n"
+  "C 33F D933\n"
+  "I 367 U\n"
+  "I 36E R\n"
+  "C 37F E8C3\n"
+  "I 387 D\n"
+  "I 388 L\n"
+  "I 3A1 U\n"
+  "I 3A6 R\n"
+  "C 3BF 72B6\n"
+  "I 3C6 D\n"
+  "I 3CF L\n"
+  "I 3EF U\n"
+  "I 3F4 R\n"
+  "C 3FF 6F2F\n"
+  "I 429 D\n"
+  "I 42E L\n"
+  "I 43A D\n"
+  "I 43D R\n"
+  "C 43F 46C4\n"
+  "I 440 D\n"
+  "I 441 L\n"
+  "I 46D U\n"
+  "I 478 R\n"
+  "C 47F BB6\n"
+  "I 4A7 D\n"
+  "I 4A8 L\n"
+  "I 4BD D\n"
+  "C 4BF 78B8\n"
+  "I 4C4 R\n"
+  "I 4D9 D\n"
+  "I 4DA L\n"
+  "C 4FF A808\n"
+  "I 509 U\n"
+  "I 512 R\n"
+  "I 518 D\n"
+  "I 51C R\n"
+  "C 53F 3EFD\n"
+  "I 54C D\n"
+  "I 551 L\n"
+  "C 57F EA77\n"
+  "I 587 U\n"
+  "I 58E R\n"
+  "I 5BF D\n"
+  "C 5BF E9E6\n"
+  "I 5C8 L\n"
+  "I 5F9 U\n"
+  "C 5FF BD5D\n"
+  "I 602 R\n"
+  "I 628 D\n"
+  "I 629 L\n"
+  "C 63F 96C3\n"
+  "I 64F U\n"
+  "I 652 R\n"
+  "I 65E D\n"
+  "I 660 R\n"
+  "I 676 D\n"
+  "I 67F L\n"
+  "C 67F BA9D\n"
+  "I 6A1 U\n"
+  "I 6A6 R\n"
+  "I 6AD D\n"
+  "I 6B1 R\n"
+  "C 6BF 6373\n"
+  "I 6CB D\n"
+  "I 6CC L\n"
+  "I 6ED U\n"
+  "I 6F2 R\n"
+  "C 6FF 7C61\n"
+  "I 72D U\n"
+  "I 72E L\n"
+  "C 73F A2A8\n"
+  "I 769 U\n"
+  "I 76E R\n"
+  "I 77B D\n"
+  "I 77D R\n"
+  "C 77F B669\n"
+  "I 790 D\n"
+  "I 792 R\n"
+  "I 797 D\n"
+  "I 79C L\n"
+  "I 7AC D\n"
+  "I 7AE L\n"
+  "C 7BF 4F32\n"
+  "I 7C3 U\n"
+  "I 7CA R\n"
+  "I 7D2 D\n"
+  "I 7D6 R\n"
+  "I 7EF D\n"
+  "I 7F0 L\n"
+  "C 7FF A488\n"
+  "I 811 U\n"
+  "I 81A R\n"
+  "I 82F D\n"
+  "I 831 R\n"
+  "C 83F A5FD\n"
+  "I 852 D\n"
+  "I 85B L\n"
+  "C 87F 8279\n"
+  "I 891 U\n"
+  "I 896 R\n"
+  "C 8BF C51\n"
+  "I 8D1 D\n"
+  "I 8D2 L\n"
+  "C 8FF EEA\n"
+  "I 90D U\n"
+  "I 914 R\n"
+  "C 93F B00A\n"
+  "I 94E U\n"
+  "I 94F L\n"
+  "C 97F 5D76\n"
+  "I 986 D\n"
+  "I 98D R\n"
+  "I 997 D\n"
+  "I 998 L\n"
+  "I 9A5 U\n"
+  "I 9AE R\n"
+  "C 9BF F79A\n"
+  "I 9C0 D\n"
+  "I 9C2 R\n"
+  "I 9C8 D\n"
+  "I 9C9 L\n"
+  "I 9E0 D\n"
+  "I 9E1 R\n"
+  "I 9E6 D\n"
+  "I 9E7 L\n"
+  "I 9EC D\n"
+  "I 9FA L\n"
+  "I 9FB U\n"
+  "C 9FF 741F\n"
+  "I A0C R\n"
+  "C A3F 8113\n"
+  "I A49 D\n"
+  "I A4A L\n"
+  "C A7F D2BC\n"
+  "I A87 U\n"
+  "I A8A R\n"
+  "I A9E D\n"
+  "I AA0 R\n"
+  "C ABF 1FD8\n"
+  "I AC5 D\n"
+  "I AC6 L\n"
+  "I AFF U\n"
+  "C AFF 8320\n"
+  "I B02 R\n"
+  "I B03 D\n"
+  "I B05 R\n"
+  "C B3F 7B1D\n"
+  "I B41 D\n"
+  "I B42 L\n"
+  "I B7F U\n"
+  "C B7F C5FD\n"
+  "I B82 R\n"
+  "I BAA D\n"
+  "I BAB L\n"
+  "I BAD D\n"
+  "I BAE R\n";
+
+#endif
@@ -0,0 +1,66 @@
+#include <unity.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "session.h"
+#include "golden_log.h"
+
+// session_replay() reads a file, so each test writes its log to one.
+static char log_path[32];
+
+static void write_log(const char *text) {
+  strcpy(log_path, "/tmp/snake_replay_XXXXXX");
+  int fd = mkstemp(log_path);
+  TEST_ASSERT_TRUE(fd >= 0);
+  FILE *f = fdopen(fd, "w");
+  fputs(text, f);
+  fclose(f);
+}
+
+void setUp() {
+  log_path[0] = '\0';
+}
+
+void tearDown() {
+  if (log_path[0] != '\0') unlink(log_path);
+}
+
+void test_golden_log_replays() {
+  write_log(golden_log);
+  TEST_ASSERT_EQUAL_INT(0, session_replay(log_path));
+}
+
+// The same log with one checksum digit changed must be caught.
+void test_diverged_log_fails() {
+  char *log = strdup(golden_log);
+  char *check = strstr(log, "\nC ");
+  TEST_ASSERT_NOT_NULL(check);
+  char *end = strchr(check + 1, '\n');
+  end[-1] = end[-1] == '0' ? '1' : '0';
+  write_log(log);
+  free(log);
+  TEST_ASSERT_EQUAL_INT(1, session_replay(log_path));
+}
+
+// A wrong final score fails the game even with every checksum right.
+void test_wrong_score_fails() {
+  char *log = strdup(golden_log);
+  char *game_end = strstr(log, "\nE ");
+  TEST_ASSERT_NOT_NULL(game_end);
+  char *end = strchr(game_end + 1, '\n');
+  end[-1] = end[-1] == '1' ? '2' : '1';
+  write_log(log);
+  free(log);
+  TEST_ASSERT_EQUAL_INT(1, session_replay(log_path));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_golden_log_replays);
+  RUN_TEST(test_diverged_log_fails);
+  RUN_TEST(test_wrong_score_fails);
+  return UNITY_END();
+}
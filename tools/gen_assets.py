@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+"""Compresses the images in assets/ into include/assets.h.
+
+Every plain or raw PBM (P1/P4) becomes a PROGMEM blob for asset_draw() in
+src/asset.cpp:
+
+    width, height, flags, runs...
+
+Runs are pixel counts alternating between clear and set, starting with
+clear, in row-major order or, with ASSET_COLUMNS in flags, column-major,
+whichever encodes smaller. A run longer than 255 continues after a
+zero-length run of the other colour. The header also gets ASSET_<NAME>_WIDTH
+and ASSET_<NAME>_HEIGHT for each image.
+
+Run from the repository root after adding or changing an image:
+
+    python3 tools/gen_assets.py
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+SOURCE = os.path.join(ROOT, 'assets')
+OUTPUT = os.path.join(ROOT, 'include', 'assets.h')
+
+ASSET_COLUMNS = 0x01
+
+
+def read_pbm(path):
+    with open(path, 'rb') as f:
+        data = f.read()
+    magic = data[:2]
+    # Header fields are separated by whitespace and may be followed by comments.
+    fields = []
+    pos = 2
+    while len(fields) < 2:
+        match = re.compile(rb'\s*(#[^\n]*\n\s*)*(\d+)').match(data, pos)
+        if match is None:
+            sys.exit('%s: bad PBM header' % path)
+        fields.append(int(match.group(2)))
+        pos = match.end()
+    width, height = fields
+    if magic == b'P1':
+        bits = [int(c) for c in re.sub(rb'#[^\n]*', b'', data[pos:]).decode() if c in '01']
+    elif magic == b'P4':
+        stride = (width + 7) // 8
+        raw = data[pos + 1:]
+        bits = [(raw[y * stride + x // 8] >> (7 - x % 8)) & 1 for y in range(height) for x in range(width)]
+    else:
+        sys.exit('%s: not a PBM image' % path)
+    if len(bits) < width * height:
+        sys.exit('%s: truncated' % path)
+    if width > 255 or height > 255:
+        sys.exit('%s: larger than 255 pixels' % path)
+    return width, height, [bits[y * width:(y + 1) * width] for y in range(height)]
+
+
+def runs(pixels):
+    out = []
+    colour, length = 0, 0
+    for pixel in pixels:
+        if pixel != colour:
+            out.append(length)
+            colour, length = pixel, 0
+        length += 1
+    out.append(length)
+    encoded = []
+    for length in out:
+        while length > 255:
+            encoded.extend([255, 0])
+            length -= 255
+        encoded.append(length)
+    return encoded
+
+
+def compress(width, height, rows):
+    by_rows = runs([rows[y][x] for y in range(height) for x in range(width)])
+    by_columns = runs([rows[y][x] for x in range(width) for y in range(height)])
+    if len(by_columns) < len(by_rows):
+        return [width, height, ASSET_COLUMNS] + by_columns
+    return [width, height, 0] + by_rows
+
+
+def main():
+    out = ['// Generated by tools/gen_assets.py from assets/, do not edit.',
+           '',
+           '#ifndef ASSETS_H',
+           '#define ASSETS_H',
+           '',
+           '#include <Arduino.h>',
+           '']
+    for name in sorted(os.listdir(SOURCE)):
+        if not name.endswith('.pbm'):
+            continue
+        width, height, rows = read_pbm(os.path.join(SOURCE, name))
+        blob = compress(width, height, rows)
+        symbol = re.sub(r'\W', '_', name[:-4]).lower()
+        out.append('// %s, %dx%d, %d bytes%s' % (name, width, height, len(blob),
+                                                ', column-major' if blob[2] & ASSET_COLUMNS else ''))
+        out.append('#define ASSET_%s_WIDTH %d' % (symbol.upper(), width))
+        out.append('#define ASSET_%s_HEIGHT %d' % (symbol.upper(), height))
+        out.append('static const uint8_t asset_%s[] PROGMEM = {' % symbol)
+        for i in range(0, len(blob), 16):
+            out.append('  ' + ', '.join('%d' % v for v in blob[i:i + 16]) + ',')
+        out.append('};')
+        out.append('')
+    out.append('#endif')
+
+    with open(OUTPUT, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
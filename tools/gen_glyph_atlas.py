@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Pre-rasterizes the GFX fonts the game prints with into include/glyph_atlas.h.
+
+Every glyph becomes a cell of one byte per row, leftmost pixel in the high
+bit, with the font's xOffset already applied and all cells of a font sharing
+the same top row relative to the baseline. src/text.cpp blits those rows
+straight into the panel buffer, and the advance tables also back the
+compile-time width measurement in include/text.h.
+
+Run from the repository root after changing a font or the list below:
+
+    python3 tools/gen_glyph_atlas.py
+"""
+
+import os
+import re
+import sys
+
+ROOT = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..'))
+OUTPUT = os.path.join(ROOT, 'include', 'glyph_atlas.h')
+
+# (id, header in lib/GFX_fonts, GFXfont symbol)
+FONTS = [
+    ('5X7', 'Font5x7FixedMono.h', 'Font5x7FixedMono'),
+    ('5X5', 'Font5x5Fixed.h', 'Font5x5Fixed'),
+    ('3X5_NUM', 'Font3x5FixedNum.h', 'Font3x5FixedNum'),
+    ('2X5_NUM', 'Font2x5FixedMonoNum.h', 'Font2x5FixedMonoNum'),
+]
+
+
+def parse_font(path, symbol):
+    with open(path) as f:
+        source = re.sub(r'//[^\n]*', '', f.read())
+    font = re.search(r'GFXfont\s+' + symbol + r'\s+PROGMEM\s*=\s*\{\s*\(uint8_t\s*\*\)\s*(\w+)\s*,'
+                     r'\s*\(GFXglyph\s*\*\)\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*(\w+)\s*\}', source)
+    if font is None:
+        sys.exit('%s: no GFXfont %s' % (path, symbol))
+    bitmap_name, glyphs_name = font.group(1), font.group(2)
+    first, last = int(font.group(3), 0), int(font.group(4), 0)
+    bitmap = re.search(bitmap_name + r'\[\]\s*PROGMEM\s*=\s*\{([^}]*)\}', source).group(1)
+    bitmap = [int(v, 0) for v in bitmap.replace(',', ' ').split()]
+    table = re.search(glyphs_name + r'\[\]\s*PROGMEM\s*=\s*\{(.*?)\};', source, re.S).group(1)
+    glyphs = [tuple(int(v) for v in g.split(','))
+              for g in re.findall(r'\{([^{}]*)\}', table)]
+    if len(glyphs) != last - first + 1:
+        sys.exit('%s: %d glyphs for 0x%02X..0x%02X' % (path, len(glyphs), first, last))
+    return first, last, bitmap, glyphs
+
+
+def rasterize(first, bitmap, glyphs):
+    inked = [g for g in glyphs if g[1] and g[2]]
+    top = min(g[5] for g in inked)
+    height = max(g[5] + g[2] for g in inked) - top
+    cells = []
+    for index, (offset, width, rows, _, x_offset, y_offset) in enumerate(glyphs):
+        if width and (x_offset < 0 or x_offset + width > 8):
+            sys.exit('glyph 0x%02X does not fit a byte' % (first + index))
+        cell = [0] * height
+        bit = 0
+        for y in range(rows):
+            for x in range(width):
+                if bitmap[offset + bit // 8] & (0x80 >> (bit % 8)):
+                    cell[y_offset - top + y] |= 0x80 >> (x_offset + x)
+                bit += 1
+        cells.append(cell)
+    return top, height, cells
+
+
+def number_lines(values, per_line=16):
+    return ['  ' + ', '.join('%d' % v for v in values[i:i + per_line]) + ','
+            for i in range(0, len(values), per_line)]
+
+
+def main():
+    out = ['// Generated by tools/gen_glyph_atlas.py from lib/GFX_fonts, do not edit.',
+           '',
+           '#ifndef GLYPH_ATLAS_H',
+           '#define GLYPH_ATLAS_H',
+           '',
+           '#include <Arduino.h>',
+           '']
+    metrics = []
+    for index, (name, header, symbol) in enumerate(FONTS):
+        first, last, bitmap, glyphs = parse_font(os.path.join(ROOT, 'lib', 'GFX_fonts', header), symbol)
+        top, height, cells = rasterize(first, bitmap, glyphs)
+        lower = name.lower()
+        out.append('// %s, 0x%02X..0x%02X, %d rows from %d above the baseline' % (symbol, first, last, height, -top))
+        out.append('#define FONT_%s %d' % (name, index))
+        out.append('static constexpr uint8_t atlas_%s_rows[] PROGMEM = {' % lower)
+        for char, cell in enumerate(cells):
+            out.append('  ' + ', '.join('0x%02X' % v for v in cell) + ',  // %r' % chr(first + char))
+        out.append('};')
+        out.append('static constexpr uint8_t atlas_%s_advance[] PROGMEM = {' % lower)
+        out.extend(number_lines([g[3] for g in glyphs]))
+        out.append('};')
+        out.append('')
+        metrics.append((name, lower, first, last, height, top))
+
+    out.append('typedef struct {')
+    out.append('  const uint8_t *rows;')
+    out.append('  const uint8_t *advance;')
+    out.append('  uint8_t first;')
+    out.append('  uint8_t last;')
+    out.append('  uint8_t height;')
+    out.append('  int8_t top;')
+    out.append('} atlas_font;')
+    out.append('')
+    out.append('static const atlas_font atlas_fonts[] PROGMEM = {')
+    for name, lower, first, last, height, top in metrics:
+        out.append('  { atlas_%s_rows, atlas_%s_advance, 0x%02X, 0x%02X, %d, %d },' % (lower, lower, first, last, height, top))
+    out.append('};')
+    out.append('')
+    out.append('// Advance of c in pixels, 0 when the font has no such glyph. Only for')
+    out.append('// constant expressions: at run time the tables must be read from flash.')
+    out.append('constexpr uint8_t atlas_advance(uint8_t font, char c) {')
+    out.append('  return')
+    for name, lower, first, last, height, top in metrics:
+        out.append('    font == FONT_%s ? (c >= 0x%02X && c <= 0x%02X ? atlas_%s_advance[c - 0x%02X] : 0) :'
+                   % (name, first, last, lower, first))
+    out.append('    0;')
+    out.append('}')
+    out.append('')
+    out.append('#endif')
+
+    with open(OUTPUT, 'w') as f:
+        f.write('\n'.join(out) + '\n')
+
+
+if __name__ == '__main__':
+    main()
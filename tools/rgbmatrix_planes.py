@@ -0,0 +1,79 @@
+"""Builds RGBmatrixPanel with a refresh interrupt for fewer bit planes.
+
+PlatformIO pre-script for [env:megaatmega2560]. The stock driver hard-wires
+nPlanes to 4 and refreshes every row once per plane; plane 0 is the costly
+one, as its bits are packed into the spare bits of the other planes' bytes
+and have to be unpacked column by column. This swaps the driver's
+RGBmatrixPanel.cpp for a patched copy in the build directory whose
+interrupt cycles through the top PANEL_PLANES planes only (see panel.h):
+
+  - after the last plane of a row it goes back to firstPlane, not 0
+  - the row address changes when firstPlane latches, not plane 0
+  - with firstPlane above 1 it steps over the rows of the planes below
+
+The buffer layout and drawPixel() are untouched, so the lower planes are
+still stored, just never shown; panel_color() keeps them dark. Each plane
+keeps its display time, so brightness only shifts by the planes left out,
+which panel_color() makes up for. Without -DPANEL_PLANES the patched
+driver behaves as the stock one.
+
+A patch that does not apply stops the build instead of building the stock
+driver unnoticed.
+"""
+
+import os
+import re
+
+Import('env')
+
+PLANES_SETUP = r'''\g<0>
+// Patched in by tools/rgbmatrix_planes.py: the refresh interrupt only
+// cycles through planes firstPlane..nPlanes-1.
+#ifndef PANEL_PLANES
+#define PANEL_PLANES nPlanes
+#endif
+#define firstPlane (nPlanes - (PANEL_PLANES))
+'''
+
+PLANE_SKIP = r'''\g<0>
+  // Patched in by tools/rgbmatrix_planes.py: a row starts at firstPlane.
+  if (firstPlane > 1 && plane == firstPlane) ptr += WIDTH * (firstPlane - 1);'''
+
+PATCHES = [
+    ('plane count', r'#define\s+nPlanes\s+4\b[^\n]*', PLANES_SETUP),
+    ('wrap to firstPlane', r'(if\s*\(\s*\+\+plane\s*>=\s*nPlanes\s*\)\s*\{[^\n]*\n\s*)plane\s*=\s*0\s*;',
+     r'\1plane = firstPlane;'),
+    ('row address on firstPlane', r'else\s+if\s*\(\s*plane\s*==\s*1\s*\)', 'else if (plane == firstPlane + 1)'),
+    ('skip lower plane rows', r'ptr\s*=\s*\(\s*uint8_t\s*\*\s*\)\s*buffptr\s*;', PLANE_SKIP),
+]
+
+
+def patch_source(text, directory):
+    for name, pattern, replacement in PATCHES:
+        text, count = re.subn(pattern, replacement, text, count=1)
+        if count != 1:
+            raise ValueError('RGBmatrixPanel.cpp: "%s" does not apply' % name)
+    # The copy is built away from the driver's own headers.
+    return re.sub(r'#include\s+"([^"/]+)"', lambda m: '#include "%s"' % os.path.join(directory, m.group(1)), text)
+
+
+def patched_driver(env, node):
+    source = node.srcnode().get_abspath()
+    with open(source) as f:
+        text = f.read()
+    try:
+        text = patch_source(text, os.path.dirname(source))
+    except ValueError as error:
+        print('Error: %s' % error)
+        env.Exit(1)
+    out_dir = os.path.join(env.subst('$BUILD_DIR'), 'rgbmatrix_planes')
+    os.makedirs(out_dir, exist_ok=True)
+    patched = os.path.join(out_dir, 'RGBmatrixPanel.cpp')
+    # Rewritten only when it changes, so the driver is not rebuilt each time.
+    if not os.path.exists(patched) or open(patched).read() != text:
+        with open(patched, 'w') as f:
+            f.write(text)
+    return env.Object(os.path.join(out_dir, 'RGBmatrixPanel.o'), patched)
+
+
+env.AddBuildMiddleware(patched_driver, '*RGBmatrixPanel.cpp')